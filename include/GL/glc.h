@@ -323,6 +323,60 @@ GLCAPI void APIENTRY glcRenderParameterfQSO(GLenum inAttrib, GLfloat inVal);
 #define GLC_QSO_render_pixmap
 #define GLC_PIXMAP_QSO                            0x8011
 
+#define GLC_QSO_render_sdf                        1
+#define GLC_SDF_QSO                               0x8012
+
+#define GLC_QSO_string_cache                      1
+#define GLC_STRING_CACHE_QSO                      0x8013
+
+#define GLC_QSO_text_object                       1
+GLCAPI GLint APIENTRY glcGenTextQSO(void);
+GLCAPI void APIENTRY glcTextStringQSO(GLint inText, const GLCchar* inString);
+GLCAPI void APIENTRY glcDrawTextQSO(GLint inText);
+GLCAPI void APIENTRY glcDeleteTextQSO(GLint inText);
+
+#define GLC_QSO_paragraph_layout                  1
+#define GLC_LINE_COUNT_QSO                        0x8014
+GLCAPI GLint APIENTRY glcLayoutParagraphQSO(GLfloat inMaxWidth,
+					    const GLCchar* inString);
+GLCAPI GLfloat* APIENTRY glcGetLineMetricQSO(GLint inLine, GLCenum inMetric,
+					     GLfloat *outVec);
+GLCAPI GLint* APIENTRY glcGetLineRangeQSO(GLint inLine, GLint *outRange);
+GLCAPI void APIENTRY glcRenderParagraphQSO(GLfloat inLineSpacing);
+
+#define GLC_QSO_measure_chars                     1
+GLCAPI GLint APIENTRY glcMeasureCharsQSO(GLint inCount,
+					 const GLCchar* inString,
+					 GLsizei inStride, GLfloat* outMetrics);
+
+#define GLC_QSO_measure_strings                   1
+GLCAPI GLint APIENTRY glcMeasureStringsQSO(GLint inCount,
+					   const GLCchar** inStrings,
+					   GLfloat* outBounds,
+					   GLfloat* outAdvances);
+
+#define GLC_QSO_stats                             1
+#define GLC_CHARMAP_HIT_COUNT_QSO                 0x8015
+#define GLC_CHARMAP_MISS_COUNT_QSO                0x8016
+#define GLC_GLYPH_LIST_HIT_COUNT_QSO              0x8017
+#define GLC_GLYPH_LIST_MISS_COUNT_QSO             0x8018
+#define GLC_GLYPH_LOAD_COUNT_QSO                  0x8019
+#define GLC_ATLAS_ALLOC_COUNT_QSO                 0x801A
+#define GLC_ATLAS_EVICTION_COUNT_QSO              0x801B
+#define GLC_TESSELATION_COUNT_QSO                 0x801C
+#define GLC_BUFFER_UPLOAD_COUNT_QSO               0x801D
+#define GLC_BUFFER_UPLOAD_BYTES_QSO               0x801E
+#define GLC_TEXTURE_UPLOAD_COUNT_QSO              0x801F
+#define GLC_TEXTURE_UPLOAD_BYTES_QSO              0x8020
+#define GLC_FONT_MATCH_COUNT_QSO                  0x8021
+#define GLC_DRAW_CALL_COUNT_QSO                   0x8022
+#define GLC_STATS_QSO                             0x8023
+#define GLC_ARENA_ALLOC_COUNT_QSO                 0x8024
+#define GLC_ARENA_HEAP_COUNT_QSO                  0x8025
+#define GLC_POOL_ALLOC_COUNT_QSO                  0x8026
+#define GLC_POOL_HEAP_COUNT_QSO                   0x8027
+GLCAPI void APIENTRY glcResetStatsQSO(void);
+
 #if defined (__cplusplus)
 }
 #endif
@@ -142,6 +142,8 @@ void APIENTRY glcDataPointer(GLvoid *inPointer)
  *  in \b GLC_LIST_OBJECT_LIST and uses the command \c glDeleteTextures to
  *  delete all of the GL objects named in \b GLC_TEXTURE_OBJECT_LIST. When an
  *  execution of glcDeleteGLObjects finishes, both of these lists are empty.
+ *  The GL objects of the text objects generated by glcGenTextQSO() are
+ *  deleted as well and those text objects become empty.
  *  \note \c glcDeleteGLObjects deletes only the objects that the current
  *  GLC context owns, not all objects in all contexts.
  *  \note Generally speaking, it is always a good idea to call
@@ -170,6 +172,10 @@ void APIENTRY glcDeleteGLObjects(void)
   for(node = ctx->fontList.head; node; node = node->next)
     __glcFaceDescDestroyGLObjects(((__GLCfont*)(node->data))->faceDesc, ctx);
 
+  /* Delete the GL objects of the text objects : they become empty */
+  for (node = ctx->textList.head; node; node = node->next)
+    __glcTextDestroyGLObjects((__GLCtext*)node, ctx);
+
   /* Delete the texture used for immediate texture mode */
   if (ctx->texture.id) {
     glDeleteTextures(1, &ctx->texture.id);
@@ -189,6 +195,12 @@ void APIENTRY glcDeleteGLObjects(void)
     glDeleteBuffersARB(1, &ctx->atlas.bufferObjectID);
     ctx->atlas.bufferObjectID = 0;
   }
+
+  /* Delete the fragment program of the GLC_SDF_QSO rendering style */
+  if (GLEW_ARB_fragment_program && ctx->sdfProgramID) {
+    glDeleteProgramsARB(1, &ctx->sdfProgramID);
+    ctx->sdfProgramID = 0;
+  }
 }
 
 
@@ -211,6 +223,7 @@ static void __glcChangeState(const GLCenum inAttrib, const GLboolean value)
   case GLC_HINTING_QSO: /* QuesoGLC Extension */
   case GLC_EXTRUDE_QSO: /* QuesoGLC Extension */
   case GLC_KERNING_QSO: /* QuesoGLC Extension */
+  case GLC_STRING_CACHE_QSO: /* QuesoGLC Extension */
     break;
   default:
     __glcRaiseError(GLC_PARAMETER_ERROR);
@@ -257,6 +270,9 @@ static void __glcChangeState(const GLCenum inAttrib, const GLboolean value)
   case GLC_KERNING_QSO:
     ctx->enableState.kerning = value;
     break;
+  case GLC_STRING_CACHE_QSO:
+    ctx->enableState.stringCache = value;
+    break;
   }
 }
 
@@ -295,6 +311,11 @@ static void __glcChangeState(const GLCenum inAttrib, const GLboolean value)
  *      <td>0x8007</td>
  *      <td><b>GL_FALSE</b></td>
  *    </tr>
+ *    <tr>
+ *      <td><b>GLC_STRING_CACHE_QSO</b></td>
+ *      <td>0x8013</td>
+ *      <td><b>GL_FALSE</b></td>
+ *    </tr>
  *  </table>
  *  </center>
  *  \param inAttrib A symbolic constant indicating a GLC capability.
@@ -332,6 +353,11 @@ void APIENTRY glcDisable(GLCenum inAttrib)
  *    before the rendering commands in order to obtain the desired thickness.
  *  - \b GLC_KERNING_QSO : if enabled, GLC uses kerning information when
  *    rendering or measuring a string. Not all fonts have kerning informations.
+ *  - \b GLC_STRING_CACHE_QSO : if enabled, GLC keeps the strings that have
+ *    been recently rendered or measured, converted in visual order, along with
+ *    the glyphs that have been used to render them. Applications which render
+ *    the same strings over and over again can then skip their conversion and
+ *    the look up of their glyphs.
  *
  *  \param inAttrib A symbolic constant indicating a GLC attribute.
  *  \sa glcDisable()
@@ -608,7 +634,7 @@ GLint APIENTRY glcGetListi(GLCenum inAttrib, GLint inIndex)
 
       for (glyphNode = faceDesc->glyphList.head; glyphNode;
 	   glyphNode = glyphNode->next) {
-	__GLCglyph* glyph = (__GLCglyph*)glyphNode;
+	__GLCglyph* glyph = (__GLCglyph*)glyphNode->data;
 	int count = __glcGlyphGetDisplayListCount(glyph);
 
 	if (inIndex < count)
@@ -697,7 +723,7 @@ GLint APIENTRY glcGetListi(GLCenum inAttrib, GLint inIndex)
 
       for (glyphNode = faceDesc->glyphList.head; glyphNode;
 	   glyphNode = glyphNode->next) {
-	__GLCglyph* glyph = (__GLCglyph*)glyphNode;
+	__GLCglyph* glyph = (__GLCglyph*)glyphNode->data;
 	int count = __glcGlyphGetBufferObjectCount(glyph);
 
 	if (inIndex < count)
@@ -791,8 +817,11 @@ const GLCchar* APIENTRY glcGetc(GLCenum inAttrib)
   static const char* __glcExtensions1 = "GLC_QSO_attrib_stack";
   static const char* __glcExtensions2 = " GLC_QSO_buffer_object";
   static const char* __glcExtensions3 = " GLC_QSO_extrude GLC_QSO_hinting"
-    " GLC_QSO_kerning GLC_QSO_matrix_stack GLC_QSO_render_parameter"
-    " GLC_QSO_render_pixmap GLC_QSO_utf8 GLC_SGI_full_name";
+    " GLC_QSO_kerning GLC_QSO_matrix_stack GLC_QSO_measure_chars"
+    " GLC_QSO_measure_strings GLC_QSO_paragraph_layout"
+    " GLC_QSO_render_parameter GLC_QSO_render_pixmap GLC_QSO_render_sdf"
+    " GLC_QSO_stats GLC_QSO_string_cache GLC_QSO_text_object GLC_QSO_utf8"
+    " GLC_SGI_full_name";
   static const GLCchar8* __glcVendor = (const GLCchar8*) "The QuesoGLC Project";
 #ifdef HAVE_CONFIG_H
   static const GLCchar8* __glcRelease = (const GLCchar8*) PACKAGE_VERSION;
@@ -826,14 +855,14 @@ const GLCchar* APIENTRY glcGetc(GLCenum inAttrib)
   switch(inAttrib) {
   case GLC_EXTENSIONS:
     {
-      GLCchar8 __glcExtensions[256];
+      GLCchar8 __glcExtensions[512];
 
       /* This assertion checks that the fixed sized array __glcExtensions is
        * large enough to store the extensions name. If this is not the case
        * then the size must be updated.
        */
       assert((strlen(__glcExtensions1) + strlen(__glcExtensions2)
-	      + strlen(__glcExtensions3)) <= 256);
+	      + strlen(__glcExtensions3)) < 512);
 
       /* Build the extensions string depending on the available GL extensions */
       strcpy((char*)__glcExtensions, __glcExtensions1);
@@ -914,6 +943,39 @@ GLfloat APIENTRY glcGetf(GLCenum inAttrib)
 
 
 
+/* Get the value of a performance counter of GLC_QSO_stats. The counters of
+ * the arena and of the pools are kept by those objects themselves : they are
+ * summed up here and saturated like the other counters.
+ */
+static GLuint __glcContextGetStat(const __GLCcontext* inContext,
+				  const GLCenum inAttrib)
+{
+  GLuint count = 0;
+
+  switch(inAttrib) {
+  case GLC_ARENA_ALLOC_COUNT_QSO:
+    __glcStatAdd(&count, inContext->arena->allocCount);
+    return count;
+  case GLC_ARENA_HEAP_COUNT_QSO:
+    __glcStatAdd(&count, inContext->arena->heapCount);
+    return count;
+  case GLC_POOL_ALLOC_COUNT_QSO:
+    __glcStatAdd(&count, inContext->glyphPool->allocCount);
+    __glcStatAdd(&count, inContext->atlasPool->allocCount);
+    __glcStatAdd(&count, inContext->nodePool->allocCount);
+    return count;
+  case GLC_POOL_HEAP_COUNT_QSO:
+    __glcStatAdd(&count, inContext->glyphPool->heapCount);
+    __glcStatAdd(&count, inContext->atlasPool->heapCount);
+    __glcStatAdd(&count, inContext->nodePool->heapCount);
+    return count;
+  default:
+    return GLC_STAT(inContext, inAttrib);
+  }
+}
+
+
+
 /** \ingroup context
  *  This command stores into \e outVec the value of the floating point vector
  *  identified by \e inAttrib. If the command does not raise an error, it
@@ -927,9 +989,16 @@ GLfloat APIENTRY glcGetf(GLCenum inAttrib)
  *  <tr>
  *    <td><b>GLC_BITMAP_MATRIX</b></td> <td>0x00D0</td> <td>[ 1. 0. 0. 1.]</td>
  *  </tr>
+ *  <tr>
+ *    <td><b>GLC_STATS_QSO</b></td> <td>0x8023</td> <td>[ 0. ... 0. ]</td>
+ *  </tr>
  *  </table>
  *  </center>
  *
+ *  \b GLC_STATS_QSO returns the 18 performance counters of the context at once,
+ *  in the order of their enumerants (from \b GLC_CHARMAP_HIT_COUNT_QSO to
+ *  \b GLC_DRAW_CALL_COUNT_QSO then from \b GLC_ARENA_ALLOC_COUNT_QSO to
+ *  \b GLC_POOL_HEAP_COUNT_QSO, see glcGeti()).
  *  \param inAttrib The parameter value to be returned
  *  \param outVec Specifies where to store the return value
  *  \return The current value of the floating point vector variable
@@ -945,7 +1014,7 @@ GLfloat* APIENTRY glcGetfv(GLCenum inAttrib, GLfloat* outVec)
   GLC_INIT_THREAD();
 
   /* Check the parameters */
-  if (inAttrib != GLC_BITMAP_MATRIX) {
+  if ((inAttrib != GLC_BITMAP_MATRIX) && (inAttrib != GLC_STATS_QSO)) {
     __glcRaiseError(GLC_PARAMETER_ERROR);
     return NULL;
   }
@@ -957,7 +1026,17 @@ GLfloat* APIENTRY glcGetfv(GLCenum inAttrib, GLfloat* outVec)
     return NULL;
   }
 
-  memcpy(outVec, ctx->bitmapMatrix, 4 * sizeof(GLfloat));
+  if (inAttrib == GLC_STATS_QSO) {            /* QuesoGLC extension */
+    int i = 0;
+
+    for (i = 0; i < GLC_STAT_COUNT; i++)
+      outVec[i] = (GLfloat)ctx->stats[i];
+    for (i = 0; i < GLC_MEMORY_STAT_COUNT; i++)
+      outVec[GLC_STAT_COUNT + i] =
+	(GLfloat)__glcContextGetStat(ctx, GLC_ARENA_ALLOC_COUNT_QSO + i);
+  }
+  else
+    memcpy(outVec, ctx->bitmapMatrix, 4 * sizeof(GLfloat));
 
   return outVec;
 }
@@ -1038,8 +1117,83 @@ GLfloat* APIENTRY glcGetfv(GLCenum inAttrib, GLfloat* outVec)
  *  <tr>
  *    <td><b>GLC_BUFFER_OBJECT_COUNT_QSO</b></td> <td>0x800E</td> <td>0</td>
  *  </tr>
+ *  <tr>
+ *    <td><b>GLC_LINE_COUNT_QSO</b></td> <td>0x8014</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_CHARMAP_HIT_COUNT_QSO</b></td> <td>0x8015</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_CHARMAP_MISS_COUNT_QSO</b></td> <td>0x8016</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_GLYPH_LIST_HIT_COUNT_QSO</b></td> <td>0x8017</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_GLYPH_LIST_MISS_COUNT_QSO</b></td> <td>0x8018</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_GLYPH_LOAD_COUNT_QSO</b></td> <td>0x8019</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_ATLAS_ALLOC_COUNT_QSO</b></td> <td>0x801A</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_ATLAS_EVICTION_COUNT_QSO</b></td> <td>0x801B</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_TESSELATION_COUNT_QSO</b></td> <td>0x801C</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_BUFFER_UPLOAD_COUNT_QSO</b></td> <td>0x801D</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_BUFFER_UPLOAD_BYTES_QSO</b></td> <td>0x801E</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_TEXTURE_UPLOAD_COUNT_QSO</b></td> <td>0x801F</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_TEXTURE_UPLOAD_BYTES_QSO</b></td> <td>0x8020</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_FONT_MATCH_COUNT_QSO</b></td> <td>0x8021</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_DRAW_CALL_COUNT_QSO</b></td> <td>0x8022</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_ARENA_ALLOC_COUNT_QSO</b></td> <td>0x8024</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_ARENA_HEAP_COUNT_QSO</b></td> <td>0x8025</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_POOL_ALLOC_COUNT_QSO</b></td> <td>0x8026</td> <td>0</td>
+ *  </tr>
+ *  <tr>
+ *    <td><b>GLC_POOL_HEAP_COUNT_QSO</b></td> <td>0x8027</td> <td>0</td>
+ *  </tr>
  *  </table>
  *  </center>
+ *
+ *  The enumerants from \b GLC_CHARMAP_HIT_COUNT_QSO to
+ *  \b GLC_DRAW_CALL_COUNT_QSO are the performance counters of the current
+ *  context. They count respectively the glyphs found and not found in the
+ *  character maps of the fonts, the glyphs found and not found in the glyph
+ *  lists of the faces, the glyphs loaded by FreeType, the areas of the texture
+ *  atlas given to a glyph and those taken back from another glyph, the
+ *  tesselations, the uploads and the bytes uploaded to GL buffer objects, the
+ *  uploads and the bytes uploaded to textures, the Fontconfig queries issued
+ *  to find a font that maps a character and the GL drawing commands. The
+ *  enumerants from \b GLC_ARENA_ALLOC_COUNT_QSO to \b GLC_POOL_HEAP_COUNT_QSO
+ *  count respectively the temporary buffers served by the arena of the context
+ *  and the blocks that it has requested to the heap, then the objects
+ *  (glyphs, atlas elements and list nodes) served by the pools of the context
+ *  and the slabs that they have requested to the heap. The difference between
+ *  the counts of a pair is the number of heap allocations that have been
+ *  saved. The counters stop at 2^31 - 1 instead of wrapping around and they
+ *  are reset by glcResetStatsQSO().
  *  \param inAttrib Attribute for which an integer variable is requested.
  *  \return The value or values of the integer variable.
  *  \sa glcGetc()
@@ -1073,6 +1227,25 @@ GLint APIENTRY glcGeti(GLCenum inAttrib)
   case GLC_MAX_MATRIX_STACK_DEPTH_QSO: /* QuesoGLC extension */
   case GLC_ATTRIB_STACK_DEPTH_QSO:     /* QuesoGLC extension */
   case GLC_MAX_ATTRIB_STACK_DEPTH_QSO: /* QuesoGLC extension */
+  case GLC_LINE_COUNT_QSO:             /* QuesoGLC extension */
+  case GLC_CHARMAP_HIT_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_CHARMAP_MISS_COUNT_QSO:     /* QuesoGLC extension */
+  case GLC_GLYPH_LIST_HIT_COUNT_QSO:   /* QuesoGLC extension */
+  case GLC_GLYPH_LIST_MISS_COUNT_QSO:  /* QuesoGLC extension */
+  case GLC_GLYPH_LOAD_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_ATLAS_ALLOC_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_ATLAS_EVICTION_COUNT_QSO:   /* QuesoGLC extension */
+  case GLC_TESSELATION_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_BUFFER_UPLOAD_COUNT_QSO:    /* QuesoGLC extension */
+  case GLC_BUFFER_UPLOAD_BYTES_QSO:    /* QuesoGLC extension */
+  case GLC_TEXTURE_UPLOAD_COUNT_QSO:   /* QuesoGLC extension */
+  case GLC_TEXTURE_UPLOAD_BYTES_QSO:   /* QuesoGLC extension */
+  case GLC_FONT_MATCH_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_DRAW_CALL_COUNT_QSO:        /* QuesoGLC extension */
+  case GLC_ARENA_ALLOC_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_ARENA_HEAP_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_POOL_ALLOC_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_POOL_HEAP_COUNT_QSO:        /* QuesoGLC extension */
     break;
   case GLC_BUFFER_OBJECT_COUNT_QSO:    /* QuesoGLC extension */
     /* This parameter is available only if the corresponding GL extensions are
@@ -1116,7 +1289,7 @@ GLint APIENTRY glcGeti(GLCenum inAttrib)
 
       for (glyphNode = faceDesc->glyphList.head; glyphNode;
 	   glyphNode = glyphNode->next) {
-	__GLCglyph* glyph = (__GLCglyph*)glyphNode;
+	__GLCglyph* glyph = (__GLCglyph*)glyphNode->data;
 
 	count += __glcGlyphGetDisplayListCount(glyph);
       }
@@ -1149,6 +1322,27 @@ GLint APIENTRY glcGeti(GLCenum inAttrib)
     return ctx->attribStackDepth;
   case GLC_MAX_ATTRIB_STACK_DEPTH_QSO: /* QuesoGLC extension */
     return GLC_MAX_ATTRIB_STACK_DEPTH;
+  case GLC_LINE_COUNT_QSO:             /* QuesoGLC extension */
+    return ctx->paragraphLines ? GLC_ARRAY_LENGTH(ctx->paragraphLines) : 0;
+  case GLC_CHARMAP_HIT_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_CHARMAP_MISS_COUNT_QSO:     /* QuesoGLC extension */
+  case GLC_GLYPH_LIST_HIT_COUNT_QSO:   /* QuesoGLC extension */
+  case GLC_GLYPH_LIST_MISS_COUNT_QSO:  /* QuesoGLC extension */
+  case GLC_GLYPH_LOAD_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_ATLAS_ALLOC_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_ATLAS_EVICTION_COUNT_QSO:   /* QuesoGLC extension */
+  case GLC_TESSELATION_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_BUFFER_UPLOAD_COUNT_QSO:    /* QuesoGLC extension */
+  case GLC_BUFFER_UPLOAD_BYTES_QSO:    /* QuesoGLC extension */
+  case GLC_TEXTURE_UPLOAD_COUNT_QSO:   /* QuesoGLC extension */
+  case GLC_TEXTURE_UPLOAD_BYTES_QSO:   /* QuesoGLC extension */
+  case GLC_FONT_MATCH_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_DRAW_CALL_COUNT_QSO:        /* QuesoGLC extension */
+  case GLC_ARENA_ALLOC_COUNT_QSO:      /* QuesoGLC extension */
+  case GLC_ARENA_HEAP_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_POOL_ALLOC_COUNT_QSO:       /* QuesoGLC extension */
+  case GLC_POOL_HEAP_COUNT_QSO:        /* QuesoGLC extension */
+    return (GLint)__glcContextGetStat(ctx, inAttrib);
   case GLC_BUFFER_OBJECT_COUNT_QSO:    /* QuesoGLC extension */
     count += (ctx->texture.bufferObjectID ? 1 : 0);
     count += (ctx->atlas.bufferObjectID ? 1 : 0);
@@ -1159,7 +1353,7 @@ GLint APIENTRY glcGeti(GLCenum inAttrib)
 
       for (glyphNode = faceDesc->glyphList.head; glyphNode;
 	   glyphNode = glyphNode->next) {
-	__GLCglyph* glyph = (__GLCglyph*)glyphNode;
+	__GLCglyph* glyph = (__GLCglyph*)glyphNode->data;
 
 	count += __glcGlyphGetBufferObjectCount(glyph);
       }
@@ -1197,6 +1391,7 @@ GLboolean APIENTRY glcIsEnabled(GLCenum inAttrib)
   case GLC_HINTING_QSO: /* QuesoGLC Extension */
   case GLC_EXTRUDE_QSO: /* QuesoGLC Extension */
   case GLC_KERNING_QSO: /* QuesoGLC Extension */
+  case GLC_STRING_CACHE_QSO: /* QuesoGLC Extension */
     break;
   default:
     __glcRaiseError(GLC_PARAMETER_ERROR);
@@ -1224,6 +1419,8 @@ GLboolean APIENTRY glcIsEnabled(GLCenum inAttrib)
     return ctx->enableState.extrude;
   case GLC_KERNING_QSO: /* QuesoGLC Extension */
     return ctx->enableState.kerning;
+  case GLC_STRING_CACHE_QSO: /* QuesoGLC Extension */
+    return ctx->enableState.stringCache;
   }
 
   return GL_FALSE;
@@ -1388,6 +1585,12 @@ void APIENTRY glcStringType(GLCenum inStringType)
  *    <td>enable</td>
  *  </tr>
  *  <tr>
+ *    <td><b>GLC_STRING_CACHE_QSO</b></td>
+ *    <td>GLboolean</td>
+ *    <td>glcIsEnabled()</td>
+ *    <td>enable</td>
+ *  </tr>
+ *  <tr>
  *    <td><b>GLC_RENDER_STYLE</b></td>
  *    <td>GLint</td>
  *    <td>glcGeti()</td>
@@ -1538,3 +1741,40 @@ void APIENTRY glcPopAttribQSO(void)
 
   return;
 }
+
+
+
+/** \ingroup context
+ *  This command resets to zero all the performance counters of the current
+ *  context (see glcGeti() with the arguments \b GLC_CHARMAP_HIT_COUNT_QSO to
+ *  \b GLC_DRAW_CALL_COUNT_QSO and \b GLC_ARENA_ALLOC_COUNT_QSO to
+ *  \b GLC_POOL_HEAP_COUNT_QSO).
+ *
+ *  The command raises \b GLC_STATE_ERROR if the issuing thread has no current
+ *  GLC context.
+ *  \sa glcGeti()
+ *  \sa glcGetfv() with argument \b GLC_STATS_QSO
+ */
+void APIENTRY glcResetStatsQSO(void)
+{
+  __GLCcontext *ctx = NULL;
+
+  GLC_INIT_THREAD();
+
+  /* Check if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return;
+  }
+
+  memset(ctx->stats, 0, sizeof(ctx->stats));
+  ctx->arena->allocCount = 0;
+  ctx->arena->heapCount = 0;
+  ctx->glyphPool->allocCount = 0;
+  ctx->glyphPool->heapCount = 0;
+  ctx->atlasPool->allocCount = 0;
+  ctx->atlasPool->heapCount = 0;
+  ctx->nodePool->allocCount = 0;
+  ctx->nodePool->heapCount = 0;
+}
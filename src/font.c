@@ -108,16 +108,14 @@ __GLCfont* __glcVerifyFontParameters(const GLint inFont)
  */
 void __glcAppendFont(__GLCcontext* inContext, __GLCfont* inFont)
 {
-  FT_ListNode node = (FT_ListNode)__glcMalloc(sizeof(FT_ListNodeRec));
+  FT_ListNode node = (FT_ListNode)__glcPoolAlloc(inContext->nodePool);
 
-  if (!node) {
-    __glcRaiseError(GLC_RESOURCE_ERROR);
+  if (!node)
     return;
-  }
 
 #ifndef GLC_FT_CACHE
   if (!__glcFontOpen(inFont, inContext)) {
-    __glcFree(node);
+    __glcPoolFree(inContext->nodePool, node);
     return;
   }
 #endif
@@ -125,6 +123,7 @@ void __glcAppendFont(__GLCcontext* inContext, __GLCfont* inFont)
   /* Add the font to GLC_CURRENT_FONT_LIST */
   node->data = inFont;
   FT_List_Add(&inContext->currentFontList, node);
+  __glcStringCacheInvalidate(inContext->stringCache);
 }
 
 
@@ -233,7 +232,7 @@ void APIENTRY glcDeleteFont(GLint inFont)
     }
   }
 
-  __glcFree(node);
+  __glcPoolFree(ctx->nodePool, node);
   __glcContextDeleteFont(ctx, font);
 }
 
@@ -327,12 +326,11 @@ void APIENTRY glcFont(GLint inFont)
       }
       else {
         /* The list is empty, create a new node */
-        node = (FT_ListNode)__glcMalloc(sizeof(FT_ListNodeRec));
+        node = (FT_ListNode)__glcPoolAlloc(ctx->nodePool);
         if (!node) {
 #ifndef GLC_FT_CACHE
 	  __glcFontClose(font);
 #endif
-          __glcRaiseError(GLC_RESOURCE_ERROR);
           return;
         }
       }
@@ -342,11 +340,11 @@ void APIENTRY glcFont(GLint inFont)
 #ifdef GLC_FT_CACHE
   /* Empties GLC_CURRENT_FONT_LIST */
   FT_List_Finalize(&ctx->currentFontList, NULL,
-		   &__glcCommonArea.memoryManager, NULL);
+		   &ctx->nodePool->memory, NULL);
 #else
   /* Close the remaining fonts in GLC_CURRENT_FONT_LIST and empty the list */
   FT_List_Finalize(&ctx->currentFontList, __glcCloseFace,
-		   &__glcCommonArea.memoryManager, NULL);
+		   &ctx->nodePool->memory, NULL);
 #endif
 
   if (inFont) {
@@ -354,6 +352,8 @@ void APIENTRY glcFont(GLint inFont)
     node->data = font;
     FT_List_Add(&ctx->currentFontList, node);
   }
+
+  __glcStringCacheInvalidate(ctx->stringCache);
 }
 
 
@@ -501,6 +501,11 @@ void APIENTRY glcFontMap(GLint inFont, GLint inCode, const GLCchar* inCharName)
   if (code < 0)
     return;
 
+  /* The strings that have been resolved with the former map are no longer
+   * valid.
+   */
+  __glcStringCacheInvalidate(ctx->stringCache);
+
   if (!inCharName)
     /* Remove the character from the map */
     __glcCharMapRemoveChar(font->charMap, code);
@@ -586,15 +591,13 @@ GLint __glcGenFontID(__GLCcontext* inContext)
   }
 
   /* Create an empty font */
-  node = (FT_ListNode)__glcMalloc(sizeof(FT_ListNodeRec));
-  if (!node) {
-    __glcRaiseError(GLC_RESOURCE_ERROR);
+  node = (FT_ListNode)__glcPoolAlloc(inContext->nodePool);
+  if (!node)
     return 0;
-  }
 
   font = __glcFontCreate(id, NULL, inContext, 0);
   if (!font) {
-    __glcFree(node);
+    __glcPoolFree(inContext->nodePool, node);
     return 0;
   }
 
@@ -988,17 +991,15 @@ __GLCfont* __glcNewFontFromMaster(GLint inFontID, __GLCmaster* inMaster,
     __glcContextDeleteFont(inContext, font);
   else {
     /* Create a new entry for GLC_FONT_LIST */
-    node = (FT_ListNode)__glcMalloc(sizeof(FT_ListNodeRec));
-    if (!node) {
-      __glcRaiseError(GLC_RESOURCE_ERROR);
+    node = (FT_ListNode)__glcPoolAlloc(inContext->nodePool);
+    if (!node)
       return NULL;
-    }
   }
 
   /* Create a new font and add it to the list GLC_FONT_LIST */
   font = __glcFontCreate(inFontID, inMaster, inContext, inCode);
   if (!font) {
-    __glcFree(node);
+    __glcPoolFree(inContext->nodePool, node);
     return NULL;
   }
   node->data = font;
@@ -59,6 +59,7 @@
 
 #include "internal.h"
 #include <stdlib.h>
+#include <string.h>
 
 #ifdef __GNUC__
 __attribute__((constructor)) void init(void);
@@ -72,10 +73,10 @@ void _fini(void);
 
 
 /* Since the common area can be accessed by any thread, this function should
- * be called before any access (read or write) to the common area. Otherwise
- * race conditions can occur. This function must also be used whenever we call
- * a function which is not reentrant (it is the case for some Fontconfig
- * entries).
+ * be called before the context table is modified or walked. Otherwise race
+ * conditions can occur. Lookups of a single context do not need the lock (see
+ * __glcEnterContextTable()). Fontconfig calls are serialized by a dedicated
+ * lock (see __glcLockFontconfig()).
  * __glcLock/__glcUnlock can be nested : they keep track of the number of
  * time they have been called and the mutex will be released as soon as
  * __glcUnlock() will be called as many time as __glcLock() was.
@@ -123,6 +124,88 @@ void __glcUnlock(void)
 
 
 
+/* Some Fontconfig entries are not reentrant : this function must be called
+ * before they are used. The Fontconfig lock is the last one of the lock
+ * hierarchy : it can be taken while the common area is locked but the common
+ * area must not be locked while the Fontconfig lock is held. Unlike
+ * __glcLock(), this function can not be nested.
+ */
+void __glcLockFontconfig(void)
+{
+#ifdef __WIN32__
+  EnterCriticalSection(&__glcCommonArea.fontconfigSection);
+#else
+  pthread_mutex_lock(&__glcCommonArea.fontconfigMutex);
+#endif
+}
+
+
+
+/* Unlock the Fontconfig lock */
+void __glcUnlockFontconfig(void)
+{
+#ifdef __WIN32__
+  LeaveCriticalSection(&__glcCommonArea.fontconfigSection);
+#else
+  pthread_mutex_unlock(&__glcCommonArea.fontconfigMutex);
+#endif
+}
+
+
+
+/* The context table is read without locking the common area. The functions
+ * below must be called before and after any read of the table in order to
+ * prevent the contexts that the issuing thread is looking at from being
+ * destroyed by another thread.
+ */
+static void __glcEnterContextTable(void)
+{
+  GLC_ATOMIC_INC(&__glcCommonArea.contextReaders);
+}
+
+
+
+static void __glcLeaveContextTable(void)
+{
+  GLC_ATOMIC_DEC(&__glcCommonArea.contextReaders);
+}
+
+
+
+/* Create a context table of 'inSize' entries which are all empty */
+static __GLCcontextTable* __glcCreateContextTable(const GLint inSize)
+{
+  const size_t size = sizeof(__GLCcontextTable)
+    + (inSize - 1) * sizeof(__GLCcontext*);
+  __GLCcontextTable* This = (__GLCcontextTable*)__glcMalloc(size);
+
+  if (!This)
+    return NULL;
+
+  memset(This, 0, size);
+  This->size = inSize;
+  return This;
+}
+
+
+
+/* Destroy the context tables that have been replaced by larger ones. */
+static void __glcDestroyRetiredContextTables(void)
+{
+  __GLCcontextTable* table = __glcCommonArea.retiredContextTables;
+
+  while (table) {
+    __GLCcontextTable* next = table->next;
+
+    __glcFree(table);
+    table = next;
+  }
+
+  __glcCommonArea.retiredContextTables = NULL;
+}
+
+
+
 #if !defined(HAVE_TLS) && !defined(__WIN32__)
 /* This function is called each time a pthread is cancelled or exits in order
  * to free its specific area
@@ -131,12 +214,28 @@ static void __glcFreeThreadArea(void *keyValue)
 {
   __GLCthreadArea *area = (__GLCthreadArea*)keyValue;
   __GLCcontext *ctx = NULL;
+  __GLCthreadCacheEntry *entry = &GLC_THREAD_CACHE_ENTRY(GLC_THREAD_SELF());
+
+  /* Give the entry of the cache back so that it can be owned by another
+   * thread (which may later be given the same ID).
+   */
+  if (entry->owner == GLC_THREAD_SELF()) {
+    entry->area = NULL;
+    GLC_ATOMIC_CAS(&entry->owner, GLC_THREAD_SELF(), 0);
+  }
 
   if (area) {
     /* Release the context which is current to the thread, if any */
     ctx = area->currentContext;
-    if (ctx)
-      ctx->isCurrent = GL_FALSE;
+    if (ctx) {
+      /* The thread is counted as a reader of the context table so that a
+       * concurrent glcDeleteContext() can not destroy the context while the
+       * compare-and-swap is executed.
+       */
+      __glcEnterContextTable();
+      GLC_ATOMIC_CAS(&ctx->state, GLC_CONTEXT_CURRENT, GLC_CONTEXT_RELEASED);
+      __glcLeaveContextTable();
+    }
     free(area); /* DO NOT use __glcFree() !!! */
   }
 }
@@ -153,6 +252,8 @@ void _fini(void)
 #endif
 {
   FT_ListNode node = NULL;
+  __GLCcontextTable* table = __glcCommonArea.contextTable;
+  int i = 0;
 #if 0
   void *key = NULL;
 #endif
@@ -160,22 +261,37 @@ void _fini(void)
   __glcLock();
 
   /* destroy remaining contexts */
-  node = __glcCommonArea.contextList.head;
+  for (i = 0; i < table->size; i++) {
+    if (table->entries[i]) {
+      __glcContextDestroy(table->entries[i]);
+      table->entries[i] = NULL;
+    }
+  }
+
+  node = __glcCommonArea.deletedContextList.head;
   while (node) {
     FT_ListNode next = node->next;
     __glcContextDestroy((__GLCcontext*)node);
     node = next;
   }
 
+  __glcDestroyRetiredContextTables();
+  __glcFree(table);
+  __glcCommonArea.contextTable = NULL;
+
 #if FC_MINOR > 2 && defined(DEBUGMODE)
+  __glcLockFontconfig();
   FcFini();
+  __glcUnlockFontconfig();
 #endif
 
   __glcUnlock();
 #ifdef __WIN32__
   DeleteCriticalSection(&__glcCommonArea.section);
+  DeleteCriticalSection(&__glcCommonArea.fontconfigSection);
 #else
   pthread_mutex_destroy(&__glcCommonArea.mutex);
+  pthread_mutex_destroy(&__glcCommonArea.fontconfigMutex);
 #endif
 
 #if 0
@@ -222,15 +338,6 @@ __attribute__((constructor)) void init(void)
 void _init(void)
 #endif
 {
-#if !defined(__WIN32__) && !defined(HAVE_TLS)
-  /* A temporary variable is used to store the PTHREAD_ONCE_INIT value because
-   * some platforms (namely Mac OSX) define PTHREAD_ONCE_INIT as a structure
-   * initialization "{.., ..}" which is not allowed to be used by C99 anywhere
-   * but at variables declaration.
-   */
-  const pthread_once_t onceInit = PTHREAD_ONCE_INIT;
-#endif
-
   /* Initialize fontconfig */
   if (!FcInit())
     goto FatalError;
@@ -247,10 +354,7 @@ void _init(void)
 #elif !defined(HAVE_TLS)
   if (pthread_key_create(&__glcCommonArea.threadKey, __glcFreeThreadArea))
     goto FatalError;
-  /* Now we can initialize our actual once_control variable by copying the value
-   * of the temporary variable onceInit.
-   */
-  __glcCommonArea.__glcInitThreadOnce = onceInit;
+  memset(__glcCommonArea.threadCache, 0, sizeof(__glcCommonArea.threadCache));
 #endif
 
   __glcCommonArea.memoryManager.user = NULL;
@@ -258,16 +362,25 @@ void _init(void)
   __glcCommonArea.memoryManager.free = __glcFreeFunc;
   __glcCommonArea.memoryManager.realloc = __glcReallocFunc;
 
-  /* Initialize the list of context states */
-  __glcCommonArea.contextList.head = NULL;
-  __glcCommonArea.contextList.tail = NULL;
+  /* Initialize the table of context states */
+  __glcCommonArea.contextTable =
+    __glcCreateContextTable(GLC_CONTEXT_TABLE_SIZE);
+  if (!__glcCommonArea.contextTable)
+    goto FatalError;
+  __glcCommonArea.contextReaders = 0;
+  __glcCommonArea.deletedContextList.head = NULL;
+  __glcCommonArea.deletedContextList.tail = NULL;
+  __glcCommonArea.retiredContextTables = NULL;
 
-  /* Initialize the mutex for access to the contextList array */
+  /* Initialize the mutex for the creation and the destruction of contexts */
 #ifdef __WIN32__
   InitializeCriticalSection(&__glcCommonArea.section);
+  InitializeCriticalSection(&__glcCommonArea.fontconfigSection);
 #else
   if (pthread_mutex_init(&__glcCommonArea.mutex, NULL))
     goto FatalError;
+  if (pthread_mutex_init(&__glcCommonArea.fontconfigMutex, NULL))
+    goto FatalError;
 #endif
 
   return;
@@ -299,18 +412,112 @@ BOOL WINAPI DllMain(HANDLE hinstDLL, DWORD dwReason, LPVOID lpvReserved)
 
 
 
-/* Get the context state corresponding to a given context ID */
+/* Get the context state corresponding to a given context ID. The contexts
+ * that are being deleted are ignored.
+ * This function must be called between __glcEnterContextTable() and
+ * __glcLeaveContextTable().
+ */
 static __GLCcontext* __glcGetContext(const GLint inContext)
+{
+  __GLCcontextTable *table = __glcCommonArea.contextTable;
+  __GLCcontext *ctx = NULL;
+
+  if ((inContext <= 0) || (inContext > table->size))
+    return NULL;
+
+  ctx = table->entries[inContext - 1];
+  if (ctx && (ctx->state == GLC_CONTEXT_DELETED))
+    return NULL;
+
+  return ctx;
+}
+
+
+
+/* Destroy the contexts that have been removed from the context table and the
+ * tables that have been retired, if no thread is reading the table. Otherwise
+ * they are kept in the list of deleted contexts until a later call.
+ * The common area must be locked by the caller.
+ */
+static void __glcCollectDeletedContexts(void)
 {
   FT_ListNode node = NULL;
 
+  /* The compare-and-swap is only used as a memory barrier to read the number
+   * of readers after the contexts have been removed from the table.
+   */
+  if (!GLC_ATOMIC_CAS(&__glcCommonArea.contextReaders, 0, 0))
+    return;
+
+  node = __glcCommonArea.deletedContextList.head;
+  while (node) {
+    FT_ListNode next = node->next;
+    __GLCcontext *ctx = (__GLCcontext*)node;
+
+    ctx->isInGlobalCommand = GL_TRUE;
+    __glcContextDestroy(ctx);
+    node = next;
+  }
+
+  __glcCommonArea.deletedContextList.head = NULL;
+  __glcCommonArea.deletedContextList.tail = NULL;
+
+  __glcDestroyRetiredContextTables();
+}
+
+
+
+/* Remove a context from the context table then destroy it as soon as no
+ * thread can access it anymore. The state of the context must have been
+ * switched to GLC_CONTEXT_DELETED by the issuing thread.
+ */
+static void __glcReclaimContext(__GLCcontext* inContext)
+{
+  assert(inContext->state == GLC_CONTEXT_DELETED);
+
   __glcLock();
-  for (node = __glcCommonArea.contextList.head; node; node = node->next)
-    if (((__GLCcontext*)node)->id == inContext) break;
+
+  __glcCommonArea.contextTable->entries[inContext->id - 1] = NULL;
+  FT_List_Add(&__glcCommonArea.deletedContextList, (FT_ListNode)inContext);
+  __glcCollectDeletedContexts();
 
   __glcUnlock();
+}
+
+
+
+/* Release a context that is current to the issuing thread and execute its
+ * pending deletion if any.
+ */
+static void __glcReleaseContext(__GLCcontext* inContext)
+{
+  GLboolean isDeleted = GL_FALSE;
+
+  /* The issuing thread is counted as a reader of the context table during the
+   * whole release sequence: as soon as the context is released, another
+   * thread may call glcDeleteContext() and reclaim it, so it must not be
+   * destroyed before 'pendingDelete' and 'state' have been read below.
+   */
+  __glcEnterContextTable();
 
-  return (__GLCcontext*)node;
+  /* Only the thread which the context is current to can release it, so the
+   * compare-and-swap can not fail. It is nonetheless needed in order to read
+   * 'pendingDelete' after the context has been released.
+   */
+  GLC_ATOMIC_CAS(&inContext->state, GLC_CONTEXT_CURRENT,
+		 GLC_CONTEXT_RELEASED);
+
+  /* If another thread has made the context current or has deleted it in the
+   * meantime, the pending deletion is left to that thread.
+   */
+  if (inContext->pendingDelete)
+    isDeleted = GLC_ATOMIC_CAS(&inContext->state, GLC_CONTEXT_RELEASED,
+			       GLC_CONTEXT_DELETED);
+
+  __glcLeaveContextTable();
+
+  if (isDeleted)
+    __glcReclaimContext(inContext);
 }
 
 
@@ -328,9 +535,15 @@ static __GLCcontext* __glcGetContext(const GLint inContext)
  */
 GLboolean APIENTRY glcIsContext(GLint inContext)
 {
+  GLboolean isContext = GL_FALSE;
+
   GLC_INIT_THREAD();
 
-  return (__glcGetContext(inContext) ? GL_TRUE : GL_FALSE);
+  __glcEnterContextTable();
+  isContext = (__glcGetContext(inContext) ? GL_TRUE : GL_FALSE);
+  __glcLeaveContextTable();
+
+  return isContext;
 }
 
 
@@ -387,35 +600,33 @@ GLint APIENTRY glcGetCurrentContext(void)
 void APIENTRY glcDeleteContext(GLint inContext)
 {
   __GLCcontext *ctx = NULL;
+  GLboolean isReleased = GL_FALSE;
 
   GLC_INIT_THREAD();
 
-  /* Lock the "Common Area" in order to prevent race conditions. Indeed, we
-   * must prevent other threads to make current the context that we are
-   * destroying.
-   */
-  __glcLock();
+  __glcEnterContextTable();
 
   /* verify if the context exists */
   ctx = __glcGetContext(inContext);
 
   if (!ctx) {
     __glcRaiseError(GLC_PARAMETER_ERROR);
-    __glcUnlock();
+    __glcLeaveContextTable();
     return;
   }
 
-  if (ctx->isCurrent)
-    /* The context is current to a thread : just mark for deletion */
-    ctx->pendingDelete = GL_TRUE;
-  else {
-    /* Remove the context from the context list then destroy it */
-    FT_List_Remove(&__glcCommonArea.contextList, (FT_ListNode)ctx);
-    ctx->isInGlobalCommand = GL_TRUE;
-    __glcContextDestroy(ctx);
-  }
+  /* Mark the context for deletion then try to prevent other threads from
+   * making it current. If the context is current to a thread, it will be
+   * destroyed when that thread releases it.
+   */
+  ctx->pendingDelete = GL_TRUE;
+  isReleased = GLC_ATOMIC_CAS(&ctx->state, GLC_CONTEXT_RELEASED,
+			      GLC_CONTEXT_DELETED);
 
-  __glcUnlock();
+  __glcLeaveContextTable();
+
+  if (isReleased)
+    __glcReclaimContext(ctx);
 }
 
 
@@ -467,84 +678,63 @@ void APIENTRY glcContext(GLint inContext)
   area = GLC_GET_THREAD_AREA();
   assert(area);
 
-  /* Lock the "Common Area" in order to prevent race conditions */
-  __glcLock();
+  /* Get the current context of the issuing thread */
+  currentContext = area->currentContext;
 
   if (inContext) {
+    __glcEnterContextTable();
+
     /* verify that the context exists */
     ctx = __glcGetContext(inContext);
 
     if (!ctx) {
       __glcRaiseError(GLC_PARAMETER_ERROR);
-      __glcUnlock();
+      __glcLeaveContextTable();
       return;
     }
 
-    /* Get the current context of the issuing thread */
-    currentContext = area->currentContext;
-
     /* Check if the issuing thread is executing a callback
      * function that has been called from GLC
      */
     if (currentContext) {
       if (currentContext->isInCallbackFunc) {
 	__glcRaiseError(GLC_STATE_ERROR);
-	__glcUnlock();
+	__glcLeaveContextTable();
 	return;
       }
     }
 
-    /* Is the context already current to a thread ? */
-    if (ctx->isCurrent) {
-      /* If the context is current to another thread => ERROR ! */
-      if (ctx != currentContext)
-	__glcRaiseError(GLC_STATE_ERROR);
-
-      /* If we get there, this means that the context 'inContext'
-       * is already current to one thread (whether it is the issuing thread
-       * or not) : there is nothing else to be done.
-       */
-      __glcUnlock();
+    /* If the context is already current to the issuing thread, there is
+     * nothing else to be done.
+     */
+    if (ctx == currentContext) {
+      __glcLeaveContextTable();
       return;
     }
 
-    /* Release old current context if any */
-    if (currentContext)
-      currentContext->isCurrent = GL_FALSE;
-
-    /* Make the context current to the thread */
-    area->currentContext = ctx;
-    ctx->isCurrent = GL_TRUE;
-  }
-  else {
-    /* inContext is null, the current thread must release its context if any */
-
-    /* Gets the current context state */
-    currentContext = area->currentContext;
-
-    if (currentContext) {
-      /* Deassociate the context from the issuing thread */
-      area->currentContext = NULL;
-      /* Release the context */
-      currentContext->isCurrent = GL_FALSE;
+    /* Make the context current to the thread unless it is current to another
+     * thread or it has been deleted in the meantime.
+     */
+    if (!GLC_ATOMIC_CAS(&ctx->state, GLC_CONTEXT_RELEASED,
+			GLC_CONTEXT_CURRENT)) {
+      if (ctx->state == GLC_CONTEXT_DELETED) {
+	__glcRaiseError(GLC_PARAMETER_ERROR);
+      }
+      else {
+	__glcRaiseError(GLC_STATE_ERROR);
+      }
+      __glcLeaveContextTable();
+      return;
     }
-  }
 
-  /* Execute pending deletion if any. Here, the variable name 'currentContext'
-   * is not appropriate any more : 'currentContext' used to be the current
-   * context but it has either been replaced by another one or it has been
-   * released.
-   */
-  if (currentContext) {
-    if (currentContext->pendingDelete) {
-      assert(!currentContext->isCurrent);
-      FT_List_Remove(&__glcCommonArea.contextList, (FT_ListNode)currentContext);
-      currentContext->isInGlobalCommand = GL_TRUE;
-      __glcContextDestroy(currentContext);
-    }
+    __glcLeaveContextTable();
   }
 
-  __glcUnlock();
+  area->currentContext = ctx;
+
+  /* Release old current context if any and execute its pending deletion */
+  if (currentContext)
+    __glcReleaseContext(currentContext);
 
   /* If the issuing thread has released its context then there is no point to
    * check for OpenGL extensions.
@@ -583,9 +773,9 @@ void APIENTRY glcContext(GLint inContext)
  */
 GLint APIENTRY glcGenContext(void)
 {
-  int newContext = 0;
+  int i = 0;
   __GLCcontext *ctx = NULL;
-  FT_ListNode node = NULL;
+  __GLCcontextTable *table = NULL;
 
   GLC_INIT_THREAD();
 
@@ -597,15 +787,51 @@ GLint APIENTRY glcGenContext(void)
   /* Lock the "Common Area" in order to prevent race conditions */
   __glcLock();
 
+  /* Take the opportunity to destroy the contexts which deletion has been
+   * deferred.
+   */
+  __glcCollectDeletedContexts();
+
   /* Search for the first context ID that is unused */
-  if (__glcCommonArea.contextList.tail)
-    newContext = ((__GLCcontext*)__glcCommonArea.contextList.tail)->id;
+  table = __glcCommonArea.contextTable;
+  for (i = 0; i < table->size; i++) {
+    if (!table->entries[i])
+      break;
+  }
+
+  if (i == table->size) {
+    /* The table is full : replace it by a copy twice as large. The old table
+     * may still be read by other threads so it is retired and will be
+     * destroyed along with the deleted contexts.
+     */
+    __GLCcontextTable *newTable = __glcCreateContextTable(2 * table->size);
+
+    if (!newTable) {
+      __glcUnlock();
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      ctx->isInGlobalCommand = GL_TRUE;
+      __glcContextDestroy(ctx);
+      return 0;
+    }
 
-  ctx->id = newContext + 1;
+    /* The entries are only modified while the common area is locked so they
+     * can not change during the copy. The compare-and-swap makes sure that
+     * the copy is complete before other threads can read the new table.
+     */
+    memcpy((void*)newTable->entries, (void*)table->entries,
+	   table->size * sizeof(__GLCcontext*));
+    GLC_ATOMIC_CAS_PTR(&__glcCommonArea.contextTable, table, newTable);
+    table->next = __glcCommonArea.retiredContextTables;
+    __glcCommonArea.retiredContextTables = table;
+    table = newTable;
+  }
 
-  node = (FT_ListNode)ctx;
-  node->data = ctx;
-  FT_List_Add(&__glcCommonArea.contextList, node);
+  ctx->id = i + 1;
+
+  /* The compare-and-swap makes sure that the context is fully initialized
+   * before other threads can find it in the table.
+   */
+  GLC_ATOMIC_CAS_PTR(&table->entries[i], NULL, ctx);
 
   __glcUnlock();
 
@@ -629,17 +855,22 @@ GLint APIENTRY glcGenContext(void)
 GLint* APIENTRY glcGetAllContexts(void)
 {
   int count = 0;
+  int i = 0;
   GLint* contextArray = NULL;
-  FT_ListNode node = NULL;
+  __GLCcontextTable* table = NULL;
 
   GLC_INIT_THREAD();
 
   /* Count the number of existing contexts (whether they are current to a
-   * thread or not).
+   * thread or not). The contexts can not be removed from the table while the
+   * common area is locked.
    */
   __glcLock();
-  for (node = __glcCommonArea.contextList.head, count = 0; node;
-       node = node->next, count++);
+  table = __glcCommonArea.contextTable;
+  for (i = 0; i < table->size; i++) {
+    if (table->entries[i])
+      count++;
+  }
 
   /* Allocate memory to store the array (including the zero termination value)*/
   contextArray = (GLint *)__glcMalloc(sizeof(GLint) * (count+1));
@@ -649,13 +880,17 @@ GLint* APIENTRY glcGetAllContexts(void)
     return NULL;
   }
 
+  /* Copy the IDs of the contexts that are not being deleted to the array */
+  for (i = 0, count = 0; i < table->size; i++) {
+    __GLCcontext *ctx = table->entries[i];
+
+    if (ctx && (ctx->state != GLC_CONTEXT_DELETED))
+      contextArray[count++] = ctx->id;
+  }
+
   /* Array must be null-terminated */
   contextArray[count] = 0;
 
-  /* Copy the context IDs to the array */
-  for (node = __glcCommonArea.contextList.tail; node; node = node->prev)
-    contextArray[--count] = ((__GLCcontext*)node)->id;
-
   __glcUnlock();
 
   return contextArray;
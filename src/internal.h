@@ -56,6 +56,7 @@
 #define GLCulong  FT_ULong
 
 #include "ofont.h"
+#include "otext.h"
 
 #define GLC_OUT_OF_RANGE_LEN	11
 #define GLC_EPSILON		1E-6
@@ -70,22 +71,30 @@
 #endif
 
 /* Definition of the GLC_INIT_THREAD macro : it is some sort of an equivalent to
- * XInitThreads(). It allows to get rid of pthread_get_specific()/TlsGetValue()
- * when only one thread is used and to fallback to the usual thread management
- * if more than one thread is used.
- * If Thread Local Storage is used the macro does nothing.
+ * XInitThreads(). On Windows, it allows to get rid of TlsGetValue() when only
+ * one thread is used and to fallback to the usual thread management if more
+ * than one thread is used.
+ * If Thread Local Storage or POSIX threads are used the macro does nothing.
  */
 #ifdef __WIN32__
 # define GLC_INIT_THREAD() \
   if (!InterlockedCompareExchange(&__glcCommonArea.__glcInitThreadOnce, 1, 0)) \
     __glcInitThread();
-#elif !defined(HAVE_TLS)
-# define GLC_INIT_THREAD() \
-  pthread_once(&__glcCommonArea.__glcInitThreadOnce, __glcInitThread);
 #else
 #define GLC_INIT_THREAD()
 #endif
 
+/* When POSIX threads are used without TLS, the thread areas are cached in a
+ * table indexed by a hash of the thread ID. The thread ID is assumed to be an
+ * integer or a pointer, which is the case on the supported platforms.
+ */
+#if !defined(__WIN32__) && !defined(HAVE_TLS)
+# define GLC_THREAD_SELF() ((size_t)pthread_self())
+# define GLC_THREAD_CACHE_ENTRY(id) \
+  (__glcCommonArea.threadCache[((GLuint)((id) ^ ((id) >> 16)) * 2654435761U) \
+			       >> (32 - GLC_THREAD_CACHE_BITS)])
+#endif
+
 /* Definition of the GLC_GET_THREAD_AREA macro */
 #ifdef __WIN32__
 # define GLC_GET_THREAD_AREA() \
@@ -93,8 +102,8 @@
     __glcThreadArea : __glcGetThreadArea())
 #elif !defined(HAVE_TLS)
 # define GLC_GET_THREAD_AREA() \
-  ((pthread_equal(__glcCommonArea.threadID, pthread_self()) && __glcThreadArea) ? \
-    __glcThreadArea : __glcGetThreadArea())
+  ((GLC_THREAD_CACHE_ENTRY(GLC_THREAD_SELF()).owner == GLC_THREAD_SELF()) ? \
+    GLC_THREAD_CACHE_ENTRY(GLC_THREAD_SELF()).area : __glcGetThreadArea())
 #else
 # define GLC_GET_THREAD_AREA() &__glcTlsThreadArea
 #endif
@@ -106,24 +115,29 @@
     __glcThreadArea->currentContext : __glcGetCurrent())
 #elif !defined(HAVE_TLS)
 # define GLC_GET_CURRENT_CONTEXT() \
-  ((pthread_equal(__glcCommonArea.threadID, pthread_self()) && __glcThreadArea) ? \
-    __glcThreadArea->currentContext : __glcGetCurrent())
+  ((GLC_THREAD_CACHE_ENTRY(GLC_THREAD_SELF()).owner == GLC_THREAD_SELF()) ? \
+    GLC_THREAD_CACHE_ENTRY(GLC_THREAD_SELF()).area->currentContext :	\
+    __glcGetCurrent())
 #else
 #define GLC_GET_CURRENT_CONTEXT() __glcTlsThreadArea.currentContext
 #endif
 
+/* Rendering styles that store the glyphs in the texture atlas */
+#define GLC_IS_TEXTURE_STYLE(style) \
+  (((style) == GLC_TEXTURE) || ((style) == GLC_SDF_QSO))
+
 /* ceil() and floor() macros for 26.6 fixed integers */
 #define GLC_CEIL_26_6(x) (((x) < 0) ? ((x) & -64) : ((x) + 63) & -64)
 #define GLC_FLOOR_26_6(x) (((x) < 0) ? (((x) - 63) & -64) : ((x) & -64))
 
 typedef struct __GLCdataCodeFromNameRec __GLCdataCodeFromName;
 typedef struct __GLCcharacterRec __GLCcharacter;
+typedef struct __GLClineRec __GLCline;
 
 struct __GLCrendererDataRec {
   GLfloat vector[8];			/* Current coordinates */
   GLfloat tolerance;			/* Chordal tolerance */
   __GLCarray* vertexArray;		/* Array of vertices */
-  __GLCarray* controlPoints;		/* Array of control points */
   __GLCarray* endContour;		/* Array of contour limits */
   __GLCarray* vertexIndices;		/* Array of vertex indices */
   __GLCarray* geomBatches;		/* Array of geometric batches */
@@ -147,17 +161,33 @@ struct __GLCgeomBatchRec {
 
 struct __GLCcharacterRec {
   GLint code;
+  GLint record;				/* Index of the glyph in 'records' */
   __GLCfont* font;
   __GLCglyph* glyph;
+  const __GLCrenderRecords* records;	/* Render records of the glyph */
   GLfloat advance[2];
 };
 
+/* A line of the paragraph laid out by glcLayoutParagraphQSO() */
+struct __GLClineRec {
+  GLint start;			/* Index of the first character */
+  GLint count;			/* Number of characters of the line */
+  GLint drawCount;		/* Same without the trailing spaces and breaks */
+  GLfloat metrics[12];		/* GLC_BASELINE and GLC_BOUNDS of the line */
+};
+
 /* Those functions are used to protect against race conditions whenever we try
- * to access the common area or functions which are not multi-threaded.
+ * to modify the context table of the common area.
  */
 void __glcLock(void);
 void __glcUnlock(void);
 
+/* Those functions serialize the calls to Fontconfig functions which are not
+ * multi-threaded. They can not be nested.
+ */
+void __glcLockFontconfig(void);
+void __glcUnlockFontconfig(void);
+
 /* Callback function type that is called by __glcProcessChar().
  * It allows to unify the character processing before the rendering or the
  * measurement of a character : __glcProcessChar() is called first (see below)
@@ -184,6 +214,9 @@ extern void* __glcProcessChar(__GLCcontext *inContext, const GLint inCode,
 			      const __glcProcessCharFunc inProcessCharFunc,
 			      const void* inProcessCharData);
 
+/* Create the GLU tesselator of a context */
+extern struct GLUtesselator* __glcTesselatorCreate(void);
+
 /* Render scalable characters using either the GLC_LINE style or the
  * GLC_TRIANGLE style
  */
@@ -331,20 +364,29 @@ extern void __glcGetScale(const __GLCcontext* inContext,
 			  GLfloat* outScaleX, GLfloat* outScaleY);
 
 /* Convert 'inString' (stored in logical order) to UCS4 format and return a
- * copy of the converted string in visual order.
+ * copy of the converted string in visual order. If the string cache is
+ * enabled, the entry of the string is returned in 'outEntry'.
  */
 extern GLCchar32* __glcConvertToVisualUcs4(__GLCcontext* inContext,
 					   GLboolean *outIsRTL,
 					   GLint *outLength,
-					   const GLCchar* inString);
+					   const GLCchar* inString,
+					   __GLCstringEntry** outEntry);
 
 /* Convert 'inCount' characters of 'inString' (stored in logical order) to UCS4
- * format and return a copy of the converted string in visual order.
+ * format and return a copy of the converted string in visual order. If the
+ * string cache is enabled, the entry of the string is returned in 'outEntry'.
  */
 extern GLCchar32* __glcConvertCountedStringToVisualUcs4(__GLCcontext* inContext,
 							GLboolean *outIsRTL,
 							const GLCchar* inString,
-							const GLint inCount);
+							const GLint inCount,
+						__GLCstringEntry** outEntry);
+
+/* Return the nominal character of 'inCode' if it is the contextual form of an
+ * Arabic letter, and 0 otherwise.
+ */
+extern GLint __glcGetNominalCode(const GLint inCode);
 
 #ifdef GLC_FT_CACHE
 /* Callback function used by the FreeType cache manager to open a given face */
@@ -375,14 +417,14 @@ GLEWAPI GLEWContext* __glcGetGlewContext(void);
 #define glewGetContext() __glcGetGlewContext()
 #endif
 
-#ifndef HAVE_TLS
+#if defined(__WIN32__) && !defined(HAVE_TLS)
 /* This function initializes the thread management of QuesoGLC when TLS is not
  * available. It must be called once (see the macro GLC_INIT_THREAD)
  */
 extern void __glcInitThread(void);
 #endif
 
-extern int __glcdeCasteljauConic(void *inUserData);
-extern int __glcdeCasteljauCubic(void *inUserData);
+extern int __glcFlattenConic(void *inUserData);
+extern int __glcFlattenCubic(void *inUserData);
 
 #endif /* __glc_internal_h */
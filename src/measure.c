@@ -62,6 +62,9 @@
 #include "internal.h"
 #include <math.h>
 
+/* Number of characters whose font is kept by glcMeasureStringsQSO() */
+#define GLC_FONT_CACHE_SIZE 256
+
 
 
 /* Multiply a vector by the GLC_BITMAP_MATRIX */
@@ -234,7 +237,7 @@ GLfloat* APIENTRY glcGetCharMetric(GLint inCode, GLCenum inMetric,
   __GLCcontext *ctx = NULL;
   GLint code = 0;
   GLfloat vector[14];
-  __GLCcharacter prevCode = { 0, NULL, NULL, {0.f, 0.f}};
+  __GLCcharacter prevCode = { 0, 0, NULL, NULL, NULL, {0.f, 0.f}};
 
   GLC_INIT_THREAD();
 
@@ -559,15 +562,85 @@ GLfloat* APIENTRY glcGetStringMetric(GLCenum inMetric, GLfloat *outVec)
 
 
 
+/* Get the metrics of the character 'inCode' from the font 'inFont' when
+ * GLC_GL_OBJECTS is enabled. 'inGlyph' is the glyph of the character in the
+ * font if it is already known, NULL otherwise. The metrics are stored in
+ * 'outMetrics' and GL_FALSE is returned if the font does not map the
+ * character.
+ */
+static GLboolean __glcMeasureCharInFont(__GLCcontext* inContext,
+					__GLCfont* inFont,
+					const __GLCglyph* inGlyph,
+					const GLCchar32 inCode,
+					__GLCcharacter* ioPrevCode,
+					const GLboolean inIsRTL,
+					GLfloat* outMetrics)
+{
+  outMetrics[0] = 0.;
+  outMetrics[1] = 0.;
+
+  if (!inGlyph || !inGlyph->advanceCached) {
+    if (!__glcFontGetAdvance(inFont, inCode, &outMetrics[2], inContext,
+			     GLC_POINT_SIZE, GLC_POINT_SIZE))
+      return GL_FALSE;
+  }
+  else {
+    outMetrics[2] = inGlyph->records->advance[inGlyph->record][0];
+    outMetrics[3] = inGlyph->records->advance[inGlyph->record][1];
+  }
+
+  if (!inGlyph || !inGlyph->boundingBoxCached) {
+    if (!__glcFontGetBoundingBox(inFont, inCode, &outMetrics[4], inContext,
+				 GLC_POINT_SIZE, GLC_POINT_SIZE))
+      return GL_FALSE;
+    outMetrics[9] = outMetrics[7];
+  }
+  else {
+    outMetrics[4] = inGlyph->boundingBox[0];
+    outMetrics[5] = inGlyph->boundingBox[1];
+    outMetrics[6] = inGlyph->boundingBox[2];
+    outMetrics[9] = inGlyph->boundingBox[3];
+  }
+
+  outMetrics[7] = outMetrics[5];
+  outMetrics[8] = outMetrics[6];
+  outMetrics[10] = outMetrics[4];
+  outMetrics[11] = outMetrics[9];
+
+  if (inContext->enableState.kerning) {
+    if (ioPrevCode->code && ioPrevCode->font == inFont) {
+      const GLint leftCode = inIsRTL ? (GLint)inCode : ioPrevCode->code;
+      const GLint rightCode = inIsRTL ? ioPrevCode->code : (GLint)inCode;
+
+      if (!__glcFontGetKerning(inFont, leftCode, rightCode, &outMetrics[12],
+			       inContext, GLC_POINT_SIZE, GLC_POINT_SIZE))
+	memset(&outMetrics[12], 0, 2*sizeof(GLfloat));
+    }
+  }
+
+  ioPrevCode->font = inFont;
+  ioPrevCode->code = inCode;
+  return GL_TRUE;
+}
+
+
+
 /* This function perform the actual work of measuring a string
  * It is called by both glcMeasureString() and glcMeasureCountedString()
  * The string inString is encoded in UCS4 and is stored in visual order.
+ * If 'outCharMetrics' is not NULL, the metrics of each character (GLC_BASELINE
+ * followed by GLC_BOUNDS) are stored in it, 'inStride' bytes apart.
+ * 'inFontCache' is either NULL or an array of GLC_FONT_CACHE_SIZE characters
+ * which keeps the fonts that the characters have been resolved to, across
+ * the strings measured by glcMeasureStringsQSO().
  */
 static GLint __glcMeasureCountedString(__GLCcontext *inContext,
-				       const GLboolean inMeasureChars,
+				       GLfloat* outCharMetrics,
+				       const GLsizei inStride,
 				       const GLint inCount,
 				       const GLCchar32* inString,
-				       const GLboolean inIsRTL)
+				       const GLboolean inIsRTL,
+				       __GLCcharacter* inFontCache)
 {
   GLint i = 0;
   GLfloat metrics[14];
@@ -576,7 +649,7 @@ static GLint __glcMeasureCountedString(__GLCcontext *inContext,
   GLfloat xMin = 0., xMax = 0.;
   GLfloat yMin = 0., yMax = 0.;
   GLfloat* outVec = inContext->measurementStringBuffer;
-  __GLCcharacter prevCode = { 0, NULL, NULL, {0.f, 0.f}};
+  __GLCcharacter prevCode = { 0, 0, NULL, NULL, NULL, {0.f, 0.f}};
   GLint shift = 1;
 
   if ((inContext->renderState.renderStyle == GLC_BITMAP)
@@ -590,9 +663,6 @@ static GLint __glcMeasureCountedString(__GLCcontext *inContext,
 
   memset(outVec, 0, 12*sizeof(GLfloat));
 
-  if (inMeasureChars)
-    GLC_ARRAY_LENGTH(inContext->measurementBuffer) = 0;
-
   /* For each character of the string, the measurement are performed and
    * gathered in the context state
    */
@@ -613,67 +683,51 @@ static GLint __glcMeasureCountedString(__GLCcontext *inContext,
       memset(metrics, 0, 14 * sizeof(GLfloat));
     }
     else {
-      FT_ListNode node = NULL;
+      GLboolean resolved = GL_FALSE;
 
       if (inContext->enableState.glObjects
 	  && inContext->renderState.renderStyle) {
-	__GLCfont* font = NULL;
-	__GLCglyph* glyph = NULL;
-
-	for (node = inContext->currentFontList.head; node ; node = node->next) {
- 	  font = (__GLCfont*)node->data;
- 	  glyph = __glcCharMapGetGlyph(font->charMap, *ptr);
-
-	  metrics[0] = 0.;
-	  metrics[1] = 0.;
-
-	  if (!glyph || !glyph->advanceCached) {
-	    if (!__glcFontGetAdvance(font, *ptr, &metrics[2], inContext,
-				     GLC_POINT_SIZE, GLC_POINT_SIZE))
-	      continue;
-          }
-	  else {
-	    metrics[2] = glyph->advance[0];
-	    metrics[3] = glyph->advance[1];
-	  }
-
-	  if (!glyph || !glyph->boundingBoxCached) {
-	    if (!__glcFontGetBoundingBox(font, *ptr, &metrics[4], inContext,
-					 GLC_POINT_SIZE, GLC_POINT_SIZE))
-	      continue;
-	    metrics[9] = metrics[7];
-	  }
-	  else {
-	    metrics[4] = glyph->boundingBox[0];
-	    metrics[5] = glyph->boundingBox[1];
-	    metrics[6] = glyph->boundingBox[2];
-	    metrics[9] = glyph->boundingBox[3];
-	  }
-
-	  metrics[7] = metrics[5];
-	  metrics[8] = metrics[6];
-	  metrics[10] = metrics[4];
-	  metrics[11] = metrics[9];
-
-	  if (inContext->enableState.kerning) {
-	    if (prevCode.code && prevCode.font == font) {
-	      const GLint leftCode = inIsRTL ? *ptr : prevCode.code;
-	      const GLint rightCode = inIsRTL ? prevCode.code : *ptr;
-
-	      if (!__glcFontGetKerning(font, leftCode, rightCode, &metrics[12],
-				       inContext, GLC_POINT_SIZE,
-				       GLC_POINT_SIZE))
-		memset(&metrics[12], 0, 2*sizeof(GLfloat));
+	__GLCcharacter* cachedChar = inFontCache ?
+	  &inFontCache[*ptr & (GLC_FONT_CACHE_SIZE - 1)] : NULL;
+
+	/* Try the font that the character has been resolved to in a previous
+	 * string of the same batch.
+	 */
+	if (cachedChar && ((GLCchar32)cachedChar->code == *ptr))
+	  resolved = __glcMeasureCharInFont(inContext, cachedChar->font,
+					    cachedChar->glyph, *ptr, &prevCode,
+					    inIsRTL, metrics);
+
+	if (!resolved) {
+	  FT_ListNode node = NULL;
+
+	  for (node = inContext->currentFontList.head; node;
+	       node = node->next) {
+	    __GLCfont* font = (__GLCfont*)node->data;
+
+	    if (__glcMeasureCharInFont(inContext, font,
+				       __glcCharMapGetGlyph(font->charMap,
+							    *ptr),
+				       *ptr, &prevCode, inIsRTL, metrics)) {
+	      if (cachedChar) {
+		cachedChar->code = *ptr;
+		cachedChar->font = font;
+		cachedChar->glyph = __glcCharMapGetGlyph(font->charMap, *ptr);
+	      }
+	      resolved = GL_TRUE;
+	      break;
 	    }
 	  }
-
-	  prevCode.font = font;
-	  prevCode.code = *ptr;
-	  break;
 	}
       }
 
-      if (!node) {
+      if (!resolved) {
+	/* __glcProcessChar() may call the callback function of the client
+	 * which may modify the fonts : the fonts of the batch are forgotten.
+	 */
+	if (inFontCache)
+	  memset(inFontCache, 0, GLC_FONT_CACHE_SIZE * sizeof(__GLCcharacter));
+
 	__glcProcessChar(inContext, *ptr, &prevCode, inIsRTL,
 			 __glcGetCharMetric, metrics);
       }
@@ -682,17 +736,18 @@ static GLint __glcMeasureCountedString(__GLCcontext *inContext,
     ptr += shift;
 
     /* If characters are to be measured then store the results */
-    if (inMeasureChars) {
-      __glcArrayAppend(inContext->measurementBuffer, metrics);
+    if (outCharMetrics) {
+      GLfloat* charMetrics = (GLfloat*)((char*)outCharMetrics + i * inStride);
+
+      memcpy(charMetrics, metrics, 12 * sizeof(GLfloat));
 
       if (i) {
-	GLfloat (*measurementBuffer)[12] =
-	  (GLfloat(*)[12])GLC_ARRAY_DATA(inContext->measurementBuffer);
-	GLfloat prevCharAdvance = measurementBuffer[i-1][2] + metrics[12];
+	GLfloat* prevCharMetrics = (GLfloat*)((char*)charMetrics - inStride);
+	GLfloat prevCharAdvance = prevCharMetrics[2] + metrics[12];
 	int j = 0;
 
 	for (j = 0; j < 6; j++)
-	  measurementBuffer[i][2*j] += prevCharAdvance;
+	  charMetrics[2*j] += prevCharAdvance;
       }
     }
 
@@ -742,15 +797,15 @@ static GLint __glcMeasureCountedString(__GLCcontext *inContext,
     for (i = 0; i < 6; i++)
       __glcTransformVector(&inContext->measurementStringBuffer[2*i],
 			   inContext->bitmapMatrix);
-    if (inMeasureChars) {
-      GLfloat (*measurementBuffer)[12] =
-	(GLfloat(*)[12])GLC_ARRAY_DATA(inContext->measurementBuffer);
+    if (outCharMetrics) {
       int j = 0;
 
       for (i = 0; i < inCount; i++) {
+	GLfloat* charMetrics = (GLfloat*)((char*)outCharMetrics
+					  + i * inStride);
+
 	for (j = 0; j < 6; j++)
-	  __glcTransformVector(&measurementBuffer[i][2*j],
-			       inContext->bitmapMatrix);
+	  __glcTransformVector(&charMetrics[2*j], inContext->bitmapMatrix);
       }
     }
   }
@@ -761,6 +816,33 @@ static GLint __glcMeasureCountedString(__GLCcontext *inContext,
 
 
 
+/* Measure a string and, if 'inMeasureChars' is GL_TRUE, store the metrics of
+ * its characters in the GLC measurement buffer.
+ */
+static GLint __glcMeasureStringToBuffer(__GLCcontext *inContext,
+					const GLboolean inMeasureChars,
+					const GLint inCount,
+					const GLCchar32* inString,
+					const GLboolean inIsRTL)
+{
+  GLfloat* charMetrics = NULL;
+
+  if (inMeasureChars) {
+    GLC_ARRAY_LENGTH(inContext->measurementBuffer) = 0;
+    /* One set of metrics will be stored for each character */
+    if (!__glcArrayReserve(inContext->measurementBuffer, inCount))
+      return 0;
+    GLC_ARRAY_LENGTH(inContext->measurementBuffer) = inCount;
+    charMetrics = (GLfloat*)GLC_ARRAY_DATA(inContext->measurementBuffer);
+  }
+
+  return __glcMeasureCountedString(inContext, charMetrics,
+				   12 * sizeof(GLfloat), inCount, inString,
+				   inIsRTL, NULL);
+}
+
+
+
 /** \ingroup measure
  *  This command is identical to the command glcRenderCountedString(), except
  *  that instead of rendering a string, the command measures the resulting
@@ -777,6 +859,13 @@ static GLint __glcMeasureCountedString(__GLCcontext *inContext,
  *  If the command does not raise an error, its return value is the value of
  *  the variable \b GLC_MEASURED_CHARACTER_COUNT.
  *
+ *  The bounding box of the string is the union of the bounding boxes of its
+ *  glyphs, so even when \e inMeasureChars is zero the outline of each glyph is
+ *  loaded from the font file the first time that the glyph is measured. Its
+ *  bounding box is then cached with the glyph, so measuring the same glyphs
+ *  again does not load them. When \b GLC_HINTING_QSO is enabled, the cache is
+ *  only valid for the last pixel size.
+ *
  *  The command raises \b GLC_PARAMETER_ERROR if \e inCount is less than zero.
  *  \param inMeasureChars Specifies whether to compute metrics only for the
  *                        string or for the characters as well.
@@ -817,12 +906,12 @@ GLint APIENTRY glcMeasureCountedString(GLboolean inMeasureChars, GLint inCount,
   }
 
   UinString = __glcConvertCountedStringToVisualUcs4(ctx, &isRightToLeft,
-						    inString, inCount);
+						    inString, inCount, NULL);
   if (!UinString)
     return 0;
 
-  count = __glcMeasureCountedString(ctx, inMeasureChars, inCount, UinString,
-				    isRightToLeft);
+  count = __glcMeasureStringToBuffer(ctx, inMeasureChars, inCount, UinString,
+				     isRightToLeft);
 
   return count;
 }
@@ -833,7 +922,9 @@ GLint APIENTRY glcMeasureCountedString(GLboolean inMeasureChars, GLint inCount,
  *  This command measures the layout that would result from rendering a string
  *  and stores the measurements in the GLC measurement buffer. This command
  *  is identical to the command glcMeasureCountedString(), except that
- *  \e inString is zero terminated, not counted.
+ *  \e inString is zero terminated, not counted. Like glcMeasureCountedString()
+ *  it loads the outline of each glyph the first time that it is measured in
+ *  order to compute the bounding box of the string.
  *
  *  If the command does not raise an error, its return value is the value of
  *  the variable \b GLC_MEASURED_CHARACTER_COUNT.
@@ -868,12 +959,690 @@ GLint APIENTRY glcMeasureString(GLboolean inMeasureChars,
     return 0;
   }
 
-  UinString = __glcConvertToVisualUcs4(ctx, &isRightToLeft, &length, inString);
+  UinString = __glcConvertToVisualUcs4(ctx, &isRightToLeft, &length, inString,
+				       NULL);
   if (!UinString)
     return 0;
 
-  count = __glcMeasureCountedString(ctx, inMeasureChars, length, UinString,
-				    isRightToLeft);
+  count = __glcMeasureStringToBuffer(ctx, inMeasureChars, length, UinString,
+				     isRightToLeft);
 
   return count;
 }
+
+
+
+/** \ingroup measure
+ *  This command measures the layout that would result from rendering the
+ *  first \e inCount elements of the array \e inString and writes the metrics
+ *  of each character directly in the array \e outMetrics supplied by the
+ *  caller. For each character, 12 floating point values are written : the
+ *  4 values of \b GLC_BASELINE followed by the 8 values of \b GLC_BOUNDS, in
+ *  the same coordinate system than the values returned by
+ *  glcGetStringCharMetric().
+ *
+ *  \e inStride is the byte offset between the metrics of two consecutive
+ *  characters. If \e inStride is zero, the metrics are tightly packed in
+ *  \e outMetrics. This allows to write the metrics straight into an array of
+ *  structures of the application.
+ *
+ *  The metrics of the overall string are computed as well and can be
+ *  retrieved with glcGetStringMetric(). Unlike glcMeasureCountedString(), the
+ *  command does not store the metrics of the characters in the GLC measurement
+ *  buffer which is left unchanged.
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inCount is less than zero
+ *  or if \e inStride is neither zero nor greater than or equal to the size of
+ *  12 floating point values.
+ *  \param inCount The number of elements to measure, starting at the first
+ *                 element.
+ *  \param inString The string to be measured.
+ *  \param inStride The byte offset between the metrics of two consecutive
+ *                  characters.
+ *  \param outMetrics The array in which to store the metrics of the
+ *                    characters.
+ *  \returns The number of measured characters if the command succeeds, zero
+ *           otherwise.
+ *  \sa glcGetStringMetric()
+ *  \sa glcMeasureCountedString()
+ */
+GLint APIENTRY glcMeasureCharsQSO(GLint inCount, const GLCchar* inString,
+				  GLsizei inStride, GLfloat* outMetrics)
+{
+  __GLCcontext *ctx = NULL;
+  GLCchar32* UinString = NULL;
+  GLboolean isRightToLeft = GL_FALSE;
+
+  /* If inString is NULL then there is no point in continuing */
+  if (!inString)
+    return 0;
+
+  GLC_INIT_THREAD();
+
+  assert(outMetrics);
+
+  /* Check the parameters */
+  if ((inCount < 0) || (inStride < 0)
+      || (inStride && (inStride < (GLsizei)(12 * sizeof(GLfloat))))) {
+    __glcRaiseError(GLC_PARAMETER_ERROR);
+    return 0;
+  }
+
+  /* Verify if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return 0;
+  }
+
+  UinString = __glcConvertCountedStringToVisualUcs4(ctx, &isRightToLeft,
+						    inString, inCount, NULL);
+  if (!UinString)
+    return 0;
+
+  return __glcMeasureCountedString(ctx, outMetrics, inStride ? inStride
+				   : (GLsizei)(12 * sizeof(GLfloat)), inCount,
+				   UinString, isRightToLeft, NULL);
+}
+
+
+
+/** \ingroup measure
+ *  This command measures the \e inCount zero terminated strings of the array
+ *  \e inStrings in a single call. For each string, the 8 values of
+ *  \b GLC_BOUNDS are written in \e outBounds and the advance of the string,
+ *  that is the vector from the first point to the second point of
+ *  \b GLC_BASELINE, is written in \e outAdvances. Either \e outBounds or
+ *  \e outAdvances can be \b NULL if the corresponding metric is not needed.
+ *  The metrics of a \b NULL string are zero.
+ *
+ *  The command gives the same results as calling glcMeasureString() with
+ *  \e inMeasureChars set to \b GL_FALSE for each string, but the context
+ *  state is looked up once for the whole batch and, when \b GLC_GL_OBJECTS is
+ *  enabled, the fonts that the characters have been resolved to are kept from
+ *  one string to the next. The metrics of the last string can be retrieved
+ *  with glcGetStringMetric() ; the GLC measurement buffer is left unchanged.
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inCount is less than
+ *  zero.
+ *  \param inCount The number of strings to measure.
+ *  \param inStrings The array of the strings to be measured.
+ *  \param outBounds An array of 8 * \e inCount values in which to store the
+ *                   bounds of the strings.
+ *  \param outAdvances An array of 2 * \e inCount values in which to store
+ *                     the advances of the strings.
+ *  \returns The number of measured strings.
+ *  \sa glcGetStringMetric()
+ *  \sa glcMeasureString()
+ */
+GLint APIENTRY glcMeasureStringsQSO(GLint inCount, const GLCchar** inStrings,
+				    GLfloat* outBounds, GLfloat* outAdvances)
+{
+  __GLCcontext *ctx = NULL;
+  __GLCcharacter fontCache[GLC_FONT_CACHE_SIZE];
+  GLint i = 0;
+
+  GLC_INIT_THREAD();
+
+  /* Check the parameters */
+  if (inCount < 0) {
+    __glcRaiseError(GLC_PARAMETER_ERROR);
+    return 0;
+  }
+
+  /* Verify if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return 0;
+  }
+
+  if (!inStrings)
+    return 0;
+
+  memset(fontCache, 0, GLC_FONT_CACHE_SIZE * sizeof(__GLCcharacter));
+
+  for (i = 0; i < inCount; i++) {
+    GLfloat* metrics = ctx->measurementStringBuffer;
+
+    if (inStrings[i]) {
+      GLCchar32* UinString = NULL;
+      GLboolean isRightToLeft = GL_FALSE;
+      GLint length = 0;
+
+      UinString = __glcConvertToVisualUcs4(ctx, &isRightToLeft, &length,
+					   inStrings[i], NULL);
+      if (!UinString)
+	return i;
+
+      __glcMeasureCountedString(ctx, NULL, 0, length, UinString,
+				isRightToLeft, fontCache);
+    }
+    else
+      memset(metrics, 0, 12 * sizeof(GLfloat));
+
+    if (outBounds)
+      memcpy(&outBounds[8 * i], &metrics[4], 8 * sizeof(GLfloat));
+
+    if (outAdvances) {
+      outAdvances[2 * i] = metrics[2] - metrics[0];
+      outAdvances[2 * i + 1] = metrics[3] - metrics[1];
+    }
+  }
+
+  return inCount;
+}
+
+
+
+/* Check if a character forces a line break (UAX #14 classes BK, CR, LF and
+ * NL).
+ */
+static GLboolean __glcIsMandatoryBreak(const GLCchar32 inCode)
+{
+  switch(inCode) {
+  case 0x000A:
+  case 0x000B:
+  case 0x000C:
+  case 0x000D:
+  case 0x0085:
+  case 0x2028:
+  case 0x2029:
+    return GL_TRUE;
+  default:
+    return GL_FALSE;
+  }
+}
+
+
+
+/* Check if a character is a space after which a line can be broken. The
+ * spaces that are at the end of a line are not taken into account in its
+ * width.
+ */
+static GLboolean __glcIsBreakSpace(const GLCchar32 inCode)
+{
+  if ((inCode == 0x0009) || (inCode == 0x0020) || (inCode == 0x1680)
+      || (inCode == 0x200B) || (inCode == 0x205F) || (inCode == 0x3000))
+    return GL_TRUE;
+
+  /* U+2007 FIGURE SPACE is a non breaking space */
+  return ((inCode >= 0x2000) && (inCode <= 0x200A) && (inCode != 0x2007));
+}
+
+
+
+/* Check if a character is an ideograph or a syllable of a script that is not
+ * written with spaces between its words : a line can be broken before and
+ * after such a character.
+ */
+static GLboolean __glcIsIdeographic(const GLCchar32 inCode)
+{
+  return (((inCode >= 0x2E80) && (inCode <= 0x2FFF))
+	  || ((inCode >= 0x3040) && (inCode <= 0x30FF))
+	  || ((inCode >= 0x3400) && (inCode <= 0x4DBF))
+	  || ((inCode >= 0x4E00) && (inCode <= 0x9FFF))
+	  || ((inCode >= 0xAC00) && (inCode <= 0xD7A3))
+	  || ((inCode >= 0xF900) && (inCode <= 0xFAFF))
+	  || ((inCode >= 0x20000) && (inCode <= 0x3FFFD)));
+}
+
+
+
+/* Check if a line can be broken between the characters 'inCode' and
+ * 'inNextCode'. This is a simplified version of the pair table of UAX #14.
+ */
+static GLboolean __glcIsBreakOpportunity(const GLCchar32 inPrevCode,
+					 const GLCchar32 inCode,
+					 const GLCchar32 inNextCode)
+{
+  /* Glue characters (NO-BREAK SPACE, WORD JOINER, ...) */
+  if ((inCode == 0x00A0) || (inCode == 0x202F) || (inCode == 0x2060)
+      || (inCode == 0xFEFF) || (inNextCode == 0x00A0)
+      || (inNextCode == 0x202F) || (inNextCode == 0x2060)
+      || (inNextCode == 0xFEFF))
+    return GL_FALSE;
+
+  /* Break after the last space of a sequence of spaces */
+  if (__glcIsBreakSpace(inCode))
+    return !__glcIsBreakSpace(inNextCode);
+
+  /* No break before the spaces nor before the closing punctuation of the CJK
+   * scripts.
+   */
+  switch(inNextCode) {
+  case 0x3001:
+  case 0x3002:
+  case 0x300D:
+  case 0x300F:
+  case 0x3011:
+  case 0x30FC:
+  case 0xFF01:
+  case 0xFF09:
+  case 0xFF0C:
+  case 0xFF0E:
+  case 0xFF1F:
+    return GL_FALSE;
+  default:
+    if (__glcIsBreakSpace(inNextCode))
+      return GL_FALSE;
+  }
+
+  /* Break after a hyphen that is inside a word */
+  if ((inCode == 0x002D) || (inCode == 0x2010) || (inCode == 0x2013))
+    return (inPrevCode > 32) && !__glcIsBreakSpace(inPrevCode)
+      && ((inNextCode < '0') || (inNextCode > '9'));
+
+  return __glcIsIdeographic(inCode) || __glcIsIdeographic(inNextCode);
+}
+
+
+
+/* Compute the metrics of the line made of the characters 'inStart' to
+ * 'inStart + inCount - 1' of the measurement buffer. The metrics are given
+ * with respect to the origin of the line.
+ */
+static void __glcSetLineMetrics(__GLCline* outLine,
+				GLfloat (*inMeasurementBuffer)[12],
+				const GLint inStart, const GLint inCount)
+{
+  GLfloat* metrics = outLine->metrics;
+  GLfloat* first = inMeasurementBuffer[inStart];
+  GLint i = 0;
+
+  memset(metrics, 0, 12 * sizeof(GLfloat));
+
+  for (i = inStart; i < inStart + inCount; i++) {
+    GLfloat* charMetrics = inMeasurementBuffer[i];
+
+    if (i == inStart) {
+      metrics[4] = charMetrics[4];
+      metrics[5] = charMetrics[5];
+      metrics[6] = charMetrics[6];
+      metrics[9] = charMetrics[9];
+    }
+    else {
+      metrics[4] = charMetrics[4] < metrics[4] ? charMetrics[4] : metrics[4];
+      metrics[5] = charMetrics[5] < metrics[5] ? charMetrics[5] : metrics[5];
+      metrics[6] = charMetrics[6] > metrics[6] ? charMetrics[6] : metrics[6];
+      metrics[9] = charMetrics[9] > metrics[9] ? charMetrics[9] : metrics[9];
+    }
+  }
+
+  if (inCount) {
+    metrics[2] = inMeasurementBuffer[inStart + inCount - 1][2] - first[0];
+    metrics[3] = inMeasurementBuffer[inStart + inCount - 1][3] - first[1];
+    metrics[4] -= first[0];
+    metrics[5] -= first[1];
+    metrics[6] -= first[0];
+    metrics[9] -= first[1];
+  }
+
+  metrics[7] = metrics[5];
+  metrics[8] = metrics[6];
+  metrics[10] = metrics[4];
+  metrics[11] = metrics[9];
+}
+
+
+
+/* Append the line made of the characters 'inStart' to 'inEnd - 1' to the lines
+ * of the paragraph.
+ */
+static GLboolean __glcAppendLine(__GLCcontext* inContext,
+				 const GLCchar32* inString,
+				 const GLint inLength, const GLint inStart,
+				 const GLint inEnd)
+{
+  GLfloat (*measurementBuffer)[12] =
+    (GLfloat(*)[12])GLC_ARRAY_DATA(inContext->measurementBuffer);
+  __GLCline line;
+
+  line.start = inStart;
+  line.count = inEnd - inStart;
+
+  /* The trailing spaces and the line break are not part of the line width */
+  for (line.drawCount = line.count; line.drawCount; line.drawCount--) {
+    GLint index = inStart + line.drawCount - 1;
+    GLCchar32 code = inContext->paragraphIsRTL ?
+      inString[inLength - 1 - index] : inString[index];
+
+    if (!__glcIsBreakSpace(code) && !__glcIsMandatoryBreak(code))
+      break;
+  }
+
+  __glcSetLineMetrics(&line, measurementBuffer, inStart, line.drawCount);
+
+  if (!__glcArrayAppend(inContext->paragraphLines, &line))
+    return GL_FALSE;
+
+  return GL_TRUE;
+}
+
+
+
+/* Break the measured string in lines whose width do not exceed 'inMaxWidth'.
+ * The characters are scanned in the order of the measurement buffer, that is
+ * in logical order.
+ */
+static GLint __glcBreakLines(__GLCcontext* inContext,
+			     const GLCchar32* inString, const GLint inLength,
+			     const GLfloat inMaxWidth)
+{
+  GLfloat (*measurementBuffer)[12] =
+    (GLfloat(*)[12])GLC_ARRAY_DATA(inContext->measurementBuffer);
+  GLint lineStart = 0;
+  GLint breakIndex = -1;
+  GLCchar32 prevCode = 0;
+  GLint i = 0;
+
+#define GLC_CODE_AT(index) (inContext->paragraphIsRTL ? \
+			    inString[inLength - 1 - (index)] : inString[index])
+
+  for (i = 0; i < inLength; i++) {
+    GLCchar32 code = GLC_CODE_AT(i);
+    GLCchar32 nextCode = (i < inLength - 1) ? GLC_CODE_AT(i + 1) : 0;
+
+    if (__glcIsMandatoryBreak(code)) {
+      /* CR LF is a single line break */
+      if ((code == 0x000D) && (nextCode == 0x000A))
+	i++;
+
+      if (!__glcAppendLine(inContext, inString, inLength, lineStart, i + 1))
+	return -1;
+      lineStart = i + 1;
+      breakIndex = -1;
+      prevCode = 0;
+      continue;
+    }
+
+    /* The spaces may overflow the line since they are not drawn at its end */
+    while ((i > lineStart) && !__glcIsBreakSpace(code)
+	   && (fabs(measurementBuffer[i][2] - measurementBuffer[lineStart][0])
+	       > inMaxWidth)) {
+      /* Break at the last opportunity or, if the line has none, break the
+       * word before the current character.
+       */
+      GLint end = (breakIndex >= lineStart) ? breakIndex + 1 : i;
+
+      if (!__glcAppendLine(inContext, inString, inLength, lineStart, end))
+	return -1;
+      lineStart = end;
+      breakIndex = -1;
+    }
+
+    if (nextCode && __glcIsBreakOpportunity(prevCode, code, nextCode))
+      breakIndex = i;
+
+    prevCode = code;
+  }
+
+#undef GLC_CODE_AT
+
+  /* The last line */
+  if (lineStart < inLength) {
+    if (!__glcAppendLine(inContext, inString, inLength, lineStart, inLength))
+      return -1;
+  }
+
+  return GLC_ARRAY_LENGTH(inContext->paragraphLines);
+}
+
+
+
+/** \ingroup measure
+ *  This command measures a paragraph and breaks it in lines whose width do not
+ *  exceed \e inMaxWidth. The string \e inString is measured only once : the
+ *  command stores the metrics of its characters in the GLC measurement buffer
+ *  like glcMeasureString() does when \e inMeasureChars is \b GL_TRUE, then it
+ *  finds the line break opportunities of the string and computes the range and
+ *  the metrics of each line from the same measurements.
+ *
+ *  A line is broken after a sequence of spaces, after a hyphen inside a word,
+ *  or before and after an ideograph. The line feed, carriage return, line
+ *  separator and paragraph separator characters always end a line. The spaces
+ *  at the end of a line are not taken into account in its width. A word that
+ *  is wider than \e inMaxWidth is broken between two of its characters.
+ *
+ *  The width \e inMaxWidth is expressed in the units of the metrics of the GLC
+ *  measurement buffer, before the transformation by \b GLC_BITMAP_MATRIX when
+ *  the render style is \b GLC_BITMAP or \b GLC_PIXMAP_QSO. The lines are kept
+ *  in the GLC context state until the next call to glcLayoutParagraphQSO() :
+ *  their ranges and their metrics can be retrieved with glcGetLineRangeQSO()
+ *  and glcGetLineMetricQSO() and the paragraph can be rendered with
+ *  glcRenderParagraphQSO() without being measured again.
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inMaxWidth is not
+ *  positive.
+ *  \param inMaxWidth The maximum width of a line.
+ *  \param inString The paragraph to be laid out.
+ *  \returns The number of lines of the paragraph, which is also the value of
+ *           the variable \b GLC_LINE_COUNT_QSO.
+ *  \sa glcGeti() with argument GLC_LINE_COUNT_QSO
+ *  \sa glcGetLineMetricQSO()
+ *  \sa glcGetLineRangeQSO()
+ *  \sa glcRenderParagraphQSO()
+ */
+GLint APIENTRY glcLayoutParagraphQSO(GLfloat inMaxWidth,
+				     const GLCchar* inString)
+{
+  __GLCcontext *ctx = NULL;
+  GLCchar32* UinString = NULL;
+  GLint length = 0;
+  GLint lineCount = 0;
+  GLint storeRenderStyle = 0;
+  GLint i = 0;
+
+  GLC_INIT_THREAD();
+
+  /* Check the parameters */
+  if (inMaxWidth <= 0.f) {
+    __glcRaiseError(GLC_PARAMETER_ERROR);
+    return 0;
+  }
+
+  /* Verify if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return 0;
+  }
+
+  /* The arrays of the paragraph are created the first time they are needed */
+  if (!ctx->paragraphString) {
+    ctx->paragraphString = __glcArrayCreate(sizeof(GLCchar32));
+    if (!ctx->paragraphString)
+      return 0;
+  }
+  if (!ctx->paragraphLines) {
+    ctx->paragraphLines = __glcArrayCreate(sizeof(__GLCline));
+    if (!ctx->paragraphLines)
+      return 0;
+  }
+
+  GLC_ARRAY_LENGTH(ctx->paragraphString) = 0;
+  GLC_ARRAY_LENGTH(ctx->paragraphLines) = 0;
+
+  /* If inString is NULL then there is no point in continuing */
+  if (!inString)
+    return 0;
+
+  UinString = __glcConvertToVisualUcs4(ctx, &ctx->paragraphIsRTL, &length,
+				       inString, NULL);
+  if (!UinString)
+    return 0;
+
+  /* Keep a copy of the characters for glcRenderParagraphQSO() since the
+   * buffer of the conversion may be reused by the next command.
+   */
+  if (!__glcArrayReserve(ctx->paragraphString, length))
+    return 0;
+  memcpy(GLC_ARRAY_DATA(ctx->paragraphString), UinString,
+	 length * sizeof(GLCchar32));
+  GLC_ARRAY_LENGTH(ctx->paragraphString) = length;
+  UinString = (GLCchar32*)GLC_ARRAY_DATA(ctx->paragraphString);
+
+  /* Measure the characters in the glyph coordinate system : the widths of the
+   * lines are compared to inMaxWidth before they are transformed.
+   */
+  storeRenderStyle = ctx->renderState.renderStyle;
+  if ((storeRenderStyle == GLC_BITMAP) || (storeRenderStyle == GLC_PIXMAP_QSO))
+    ctx->renderState.renderStyle = 0;
+
+  if (__glcMeasureStringToBuffer(ctx, GL_TRUE, length, UinString,
+				 ctx->paragraphIsRTL) == length)
+    lineCount = __glcBreakLines(ctx, UinString, length, inMaxWidth);
+  else
+    lineCount = -1;
+
+  ctx->renderState.renderStyle = storeRenderStyle;
+
+  if (lineCount < 0) {
+    GLC_ARRAY_LENGTH(ctx->paragraphLines) = 0;
+    return 0;
+  }
+
+  /* Transform all the data in the screen coordinate system if the rendering
+   * style is GLC_BITMAP or GLC_PIXMAP_QSO.
+   */
+  if ((storeRenderStyle == GLC_BITMAP)
+      || (storeRenderStyle == GLC_PIXMAP_QSO)) {
+    GLfloat (*measurementBuffer)[12] =
+      (GLfloat(*)[12])GLC_ARRAY_DATA(ctx->measurementBuffer);
+    __GLCline* lines = (__GLCline*)GLC_ARRAY_DATA(ctx->paragraphLines);
+    int j = 0;
+
+    for (i = 0; i < 6; i++)
+      __glcTransformVector(&ctx->measurementStringBuffer[2*i],
+			   ctx->bitmapMatrix);
+
+    for (i = 0; i < length; i++) {
+      for (j = 0; j < 6; j++)
+	__glcTransformVector(&measurementBuffer[i][2*j], ctx->bitmapMatrix);
+    }
+
+    for (i = 0; i < lineCount; i++) {
+      for (j = 0; j < 6; j++)
+	__glcTransformVector(&lines[i].metrics[2*j], ctx->bitmapMatrix);
+    }
+  }
+
+  return lineCount;
+}
+
+
+
+/** \ingroup measure
+ *  This command retrieves a metric of a line of the paragraph laid out by the
+ *  last call to glcLayoutParagraphQSO() and stores it in \e outVec. The metric
+ *  is identified by \e inMetric and is computed with respect to the origin of
+ *  the line, which is its first character in logical order.
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inLine is less than zero or
+ *  is greater than or equal to the value of the variable
+ *  \b GLC_LINE_COUNT_QSO.
+ *  \param inLine Specifies which line of the paragraph to measure.
+ *  \param inMetric The metric to measure, either \b GLC_BASELINE or
+ *                  \b GLC_BOUNDS.
+ *  \param outVec A vector in which to store value of \e inMetric for the line
+ *                identified by \e inLine.
+ *  \returns \e outVec if the command succeeds, \b NULL otherwise.
+ *  \sa glcLayoutParagraphQSO()
+ *  \sa glcGetLineRangeQSO()
+ */
+GLfloat* APIENTRY glcGetLineMetricQSO(GLint inLine, GLCenum inMetric,
+				      GLfloat *outVec)
+{
+  __GLCcontext *ctx = NULL;
+  __GLCline* lines = NULL;
+
+  GLC_INIT_THREAD();
+
+  assert(outVec);
+
+  /* Check the parameters */
+  switch(inMetric) {
+  case GLC_BASELINE:
+  case GLC_BOUNDS:
+    break;
+  default:
+    __glcRaiseError(GLC_PARAMETER_ERROR);
+    return NULL;
+  }
+
+  /* Verify if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return NULL;
+  }
+
+  /* Verify that inLine is in legal bounds */
+  if ((inLine < 0) || !ctx->paragraphLines
+      || (inLine >= GLC_ARRAY_LENGTH(ctx->paragraphLines))) {
+    __glcRaiseError(GLC_PARAMETER_ERROR);
+    return NULL;
+  }
+
+  lines = (__GLCline*)GLC_ARRAY_DATA(ctx->paragraphLines);
+
+  switch(inMetric) {
+  case GLC_BASELINE:
+    memcpy(outVec, lines[inLine].metrics, 4 * sizeof(GLfloat));
+    return outVec;
+  case GLC_BOUNDS:
+    memcpy(outVec, &lines[inLine].metrics[4], 8 * sizeof(GLfloat));
+    return outVec;
+  }
+
+  return NULL;
+}
+
+
+
+/** \ingroup measure
+ *  This command retrieves the range of the characters of a line of the
+ *  paragraph laid out by the last call to glcLayoutParagraphQSO(). The index
+ *  of the first character of the line is stored in <em>outRange[0]</em> and
+ *  the number of its characters, including the trailing spaces and the line
+ *  break if any, is stored in <em>outRange[1]</em>. The indices are those of
+ *  the GLC measurement buffer, which can be passed to glcGetStringCharMetric().
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inLine is less than zero or
+ *  is greater than or equal to the value of the variable
+ *  \b GLC_LINE_COUNT_QSO.
+ *  \param inLine Specifies which line of the paragraph is requested.
+ *  \param outRange A vector of two integers in which to store the range.
+ *  \returns \e outRange if the command succeeds, \b NULL otherwise.
+ *  \sa glcLayoutParagraphQSO()
+ *  \sa glcGetLineMetricQSO()
+ */
+GLint* APIENTRY glcGetLineRangeQSO(GLint inLine, GLint *outRange)
+{
+  __GLCcontext *ctx = NULL;
+  __GLCline* lines = NULL;
+
+  GLC_INIT_THREAD();
+
+  assert(outRange);
+
+  /* Verify if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return NULL;
+  }
+
+  /* Verify that inLine is in legal bounds */
+  if ((inLine < 0) || !ctx->paragraphLines
+      || (inLine >= GLC_ARRAY_LENGTH(ctx->paragraphLines))) {
+    __glcRaiseError(GLC_PARAMETER_ERROR);
+    return NULL;
+  }
+
+  lines = (__GLCline*)GLC_ARRAY_DATA(ctx->paragraphLines);
+  outRange[0] = lines[inLine].start;
+  outRange[1] = lines[inLine].count;
+
+  return outRange;
+}
@@ -112,16 +112,21 @@ __GLCthreadArea* __glcGetThreadArea(void)
     free(area);
     return NULL;
   }
-#else
-  pthread_setspecific(__glcCommonArea.threadKey, (void*)area);
-#endif
 
-#ifdef __WIN32__
   if (__glcCommonArea.threadID == GetCurrentThreadId())
+    __glcThreadArea = area;
 #else
-  if (pthread_equal(__glcCommonArea.threadID, pthread_self()))
+  pthread_setspecific(__glcCommonArea.threadKey, (void*)area);
+
+  /* Try to own the entry of the cache that corresponds to the thread. If the
+   * entry is already owned by another thread, the area will be retrieved with
+   * pthread_getspecific().
+   */
+  if (GLC_ATOMIC_CAS(&GLC_THREAD_CACHE_ENTRY(GLC_THREAD_SELF()).owner, 0,
+		     GLC_THREAD_SELF()))
+    GLC_THREAD_CACHE_ENTRY(GLC_THREAD_SELF()).area = area;
 #endif
-    __glcThreadArea = area;
+
   return area;
 }
 
@@ -174,12 +179,31 @@ void* __glcProcessChar(__GLCcontext *inContext, const GLint inCode,
 		       const void* inProcessCharData)
 {
   GLint repCode = 0;
+  GLint nominalCode = 0;
   __GLCfont* font = NULL;
   void* ret = NULL;
 
   if (!inCode)
     return NULL;
 
+  /* The Arabic letters of the strings are replaced by their contextual forms
+   * when the strings are converted. If no font of GLC_CURRENT_FONT_LIST maps
+   * the contextual form of a letter, the nominal letter is processed instead.
+   */
+  nominalCode = __glcGetNominalCode(inCode);
+  if (nominalCode) {
+    FT_ListNode node = NULL;
+
+    for (node = inContext->currentFontList.head; node; node = node->next) {
+      if (__glcFontHasChar((__GLCfont*)node->data, inCode))
+	break;
+    }
+
+    if (!node)
+      return __glcProcessChar(inContext, nominalCode, inPrevCode, inIsRTL,
+			      inProcessCharFunc, inProcessCharData);
+  }
+
   /* Get a font that maps inCode */
   font = __glcContextGetFont(inContext, inCode);
   if (font) {
@@ -459,10 +483,20 @@ void __glcGetScale(const __GLCcontext* inContext, GLfloat* outTransformMatrix,
 void __glcSaveGLState(__GLCglState* inGLState, const __GLCcontext* inContext,
 		      const GLboolean inAll)
 {
-  if (inAll || inContext->renderState.renderStyle == GLC_TEXTURE) {
+  if (inAll || GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)) {
     inGLState->blend = glIsEnabled(GL_BLEND);
     glGetIntegerv(GL_BLEND_SRC, &inGLState->blendSrc);
     glGetIntegerv(GL_BLEND_DST, &inGLState->blendDst);
+    if (inAll || inContext->renderState.renderStyle == GLC_SDF_QSO) {
+      inGLState->alphaTest = glIsEnabled(GL_ALPHA_TEST);
+      glGetIntegerv(GL_ALPHA_TEST_FUNC, &inGLState->alphaFunc);
+      glGetFloatv(GL_ALPHA_TEST_REF, &inGLState->alphaRef);
+      if (GLEW_ARB_fragment_program) {
+	inGLState->fragmentProgram = glIsEnabled(GL_FRAGMENT_PROGRAM_ARB);
+	glGetProgramivARB(GL_FRAGMENT_PROGRAM_ARB, GL_PROGRAM_BINDING_ARB,
+			  &inGLState->fragmentProgramID);
+      }
+    }
     glGetIntegerv(GL_TEXTURE_BINDING_2D, &inGLState->textureID);
     glGetTexEnviv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE,
 		  &inGLState->textureEnvMode);
@@ -515,9 +549,8 @@ void __glcSaveGLState(__GLCglState* inGLState, const __GLCcontext* inContext,
 
   if (inAll || inContext->renderState.renderStyle == GLC_LINE
       || inContext->renderState.renderStyle == GLC_TRIANGLE
-      || (inContext->renderState.renderStyle == GLC_TEXTURE
-	  && inContext->enableState.glObjects
-	  && GLEW_ARB_vertex_buffer_object)) {
+      || (GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)
+	  && inContext->enableState.glObjects)) {
     inGLState->vertexArray = glIsEnabled(GL_VERTEX_ARRAY);
     glGetIntegerv(GL_VERTEX_ARRAY_SIZE, &inGLState->vertexArraySize);
     glGetIntegerv(GL_VERTEX_ARRAY_TYPE, &inGLState->vertexArrayType);
@@ -527,7 +560,7 @@ void __glcSaveGLState(__GLCglState* inGLState, const __GLCcontext* inContext,
     inGLState->colorArray = glIsEnabled(GL_COLOR_ARRAY);
     inGLState->indexArray = glIsEnabled(GL_INDEX_ARRAY);
     inGLState->texCoordArray = glIsEnabled(GL_TEXTURE_COORD_ARRAY);
-    if (inAll || inContext->renderState.renderStyle == GLC_TEXTURE) {
+    if (inAll || GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)) {
       glGetIntegerv(GL_TEXTURE_COORD_ARRAY_SIZE, &inGLState->texCoordArraySize);
       glGetIntegerv(GL_TEXTURE_COORD_ARRAY_TYPE, &inGLState->texCoordArrayType);
       glGetIntegerv(GL_TEXTURE_COORD_ARRAY_STRIDE,
@@ -545,10 +578,21 @@ void __glcSaveGLState(__GLCglState* inGLState, const __GLCcontext* inContext,
 void __glcRestoreGLState(const __GLCglState* inGLState,
 			 const __GLCcontext* inContext, const GLboolean inAll)
 {
-  if (inAll || inContext->renderState.renderStyle == GLC_TEXTURE) {
+  if (inAll || GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)) {
     if (!inGLState->blend)
       glDisable(GL_BLEND);
     glBlendFunc(inGLState->blendSrc, inGLState->blendDst);
+    if (inAll || inContext->renderState.renderStyle == GLC_SDF_QSO) {
+      if (!inGLState->alphaTest)
+	glDisable(GL_ALPHA_TEST);
+      glAlphaFunc(inGLState->alphaFunc, inGLState->alphaRef);
+      if (GLEW_ARB_fragment_program) {
+	if (!inGLState->fragmentProgram)
+	  glDisable(GL_FRAGMENT_PROGRAM_ARB);
+	glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB,
+			 inGLState->fragmentProgramID);
+      }
+    }
     glBindTexture(GL_TEXTURE_2D, inGLState->textureID);
     glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, inGLState->textureEnvMode);
     if ((inAll || !inContext->enableState.glObjects)
@@ -600,9 +644,8 @@ void __glcRestoreGLState(const __GLCglState* inGLState,
 
   if (inAll || inContext->renderState.renderStyle == GLC_LINE
       || inContext->renderState.renderStyle == GLC_TRIANGLE
-      || (inContext->renderState.renderStyle == GLC_TEXTURE
-	  && inContext->enableState.glObjects
-	  && GLEW_ARB_vertex_buffer_object)) {
+      || (GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)
+	  && inContext->enableState.glObjects)) {
     if (!inGLState->vertexArray)
       glDisableClientState(GL_VERTEX_ARRAY);
     glVertexPointer(inGLState->vertexArraySize, inGLState->vertexArrayType,
@@ -616,7 +659,7 @@ void __glcRestoreGLState(const __GLCglState* inGLState,
       glDisableClientState(GL_INDEX_ARRAY);
     if (!inGLState->texCoordArray)
       glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-    if (inAll || inContext->renderState.renderStyle == GLC_TEXTURE)
+    if (inAll || GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle))
       glTexCoordPointer(inGLState->texCoordArraySize,
 			inGLState->texCoordArrayType,
 			inGLState->texCoordArrayStride,
@@ -648,12 +691,8 @@ GLEWContext* __glcGetGlewContext(void)
 /* This function initializes the thread management of QuesoGLC when TLS is not
  * available. It must be called once (see the macro GLC_INIT_THREAD)
  */
-#ifndef HAVE_TLS
+#if defined(__WIN32__) && !defined(HAVE_TLS)
 void __glcInitThread(void) {
-#ifdef __WIN32__
   __glcCommonArea.threadID = GetCurrentThreadId();
-#else
-  __glcCommonArea.threadID = pthread_self();
-#endif /* __WIN32__ */
 }
-#endif /* HAVE_TLS */
+#endif /* __WIN32__ && !HAVE_TLS */
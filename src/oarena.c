@@ -0,0 +1,164 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * defines the object __GLCarena which is a stack allocator that serves the
+ * transient buffers needed by the GLC commands (pixmaps of the glyphs,
+ * characters of the strings and so on).
+ */
+
+/* The buffers are carved in blocks of memory that are kept from one GLC
+ * command to the other so that, once the arena has grown to the size needed
+ * by the application, the buffers no longer cost any call to the heap
+ * allocator. The buffers should be released in the reverse order of their
+ * allocation : __glcArenaFree() then gives the room back to the arena. If
+ * they are not, their room is recovered when the arena is reset at the end of
+ * the GLC command.
+ */
+
+#include "internal.h"
+
+#define GLC_ARENA_BLOCK_SIZE 65536
+#define GLC_ARENA_ALIGN 16
+#define GLC_ARENA_ROUND(size) (((size) + GLC_ARENA_ALIGN - 1) \
+			       & ~((size_t)GLC_ARENA_ALIGN - 1))
+#define GLC_ARENA_HEADER_SIZE GLC_ARENA_ROUND(sizeof(__GLCarenaBlock))
+#define GLC_ARENA_BLOCK_DATA(block) ((char*)(block) + GLC_ARENA_HEADER_SIZE)
+
+
+
+/* Constructor of the object : no memory is allocated for the buffers until
+ * the first of them is requested.
+ */
+__GLCarena* __glcArenaCreate(void)
+{
+  __GLCarena* This = NULL;
+
+  This = (__GLCarena*)__glcMalloc(sizeof(__GLCarena));
+  if (!This) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    return NULL;
+  }
+  memset(This, 0, sizeof(__GLCarena));
+
+  return This;
+}
+
+
+
+/* Destructor of the object */
+void __glcArenaDestroy(__GLCarena* This)
+{
+  __GLCarenaBlock* block = This->block;
+
+  while (block) {
+    __GLCarenaBlock* previous = block->previous;
+
+    __glcFree(block);
+    block = previous;
+  }
+
+  __glcFree(This);
+}
+
+
+
+/* Allocate a buffer of 'inSize' bytes in the arena. A new block is allocated
+ * in the heap if the current one is full : since the buffers that have
+ * already been allocated must not move, the current block is kept until the
+ * arena is reset. The function returns NULL if it fails and raises an error
+ * accordingly.
+ */
+void* __glcArenaAlloc(__GLCarena* This, const size_t inSize)
+{
+  __GLCarenaBlock* block = This->block;
+  size_t size = GLC_ARENA_ROUND(inSize);
+  char* buffer = NULL;
+
+  if (!block || (block->used + size > block->size)) {
+    size_t blockSize = block ? 2 * block->size : GLC_ARENA_BLOCK_SIZE;
+
+    if (blockSize < size)
+      blockSize = size;
+
+    block = (__GLCarenaBlock*)__glcMalloc(GLC_ARENA_HEADER_SIZE + blockSize);
+    if (!block) {
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      return NULL;
+    }
+
+    block->previous = This->block;
+    block->size = blockSize;
+    block->used = 0;
+    This->block = block;
+    This->heapCount++;
+  }
+
+  buffer = GLC_ARENA_BLOCK_DATA(block) + block->used;
+  block->used += size;
+  This->allocCount++;
+
+  return buffer;
+}
+
+
+
+/* Release a buffer. If the buffer is the last one that has been allocated in
+ * the current block, its room is given back to the arena (as well as the room
+ * of the buffers that may have been allocated after it). Otherwise the room is
+ * recovered when the arena is reset.
+ */
+void __glcArenaFree(__GLCarena* This, void* inBuffer)
+{
+  __GLCarenaBlock* block = This->block;
+  char* data = NULL;
+
+  if (!inBuffer || !block)
+    return;
+
+  data = GLC_ARENA_BLOCK_DATA(block);
+  if (((char*)inBuffer >= data) && ((char*)inBuffer < data + block->used))
+    block->used = (char*)inBuffer - data;
+}
+
+
+
+/* Release all the buffers of the arena. Only the last block, which is also the
+ * largest one, is kept so that the arena does not need to call the heap
+ * allocator anymore when the next GLC command needs the same amount of memory.
+ */
+void __glcArenaReset(__GLCarena* This)
+{
+  __GLCarenaBlock* block = This->block;
+
+  if (!block)
+    return;
+
+  block = block->previous;
+  while (block) {
+    __GLCarenaBlock* previous = block->previous;
+
+    __glcFree(block);
+    block = previous;
+  }
+
+  This->block->previous = NULL;
+  This->block->used = 0;
+}
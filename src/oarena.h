@@ -0,0 +1,49 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * header of the object __GLCarena which is a stack allocator that serves the
+ * transient buffers needed by the GLC commands.
+ */
+
+#ifndef __glc_oarena_h
+#define __glc_oarena_h
+
+typedef struct __GLCarenaRec __GLCarena;
+typedef struct __GLCarenaBlockRec __GLCarenaBlock;
+
+struct __GLCarenaBlockRec {
+  __GLCarenaBlock* previous;	/* Block that was allocated before this one */
+  size_t size;			/* Room available in the block */
+  size_t used;			/* Room used by the buffers */
+};
+
+struct __GLCarenaRec {
+  __GLCarenaBlock* block;	/* Block where the buffers are allocated */
+  GLuint allocCount;		/* Number of buffers served by the arena */
+  GLuint heapCount;		/* Number of blocks allocated in the heap */
+};
+
+__GLCarena* __glcArenaCreate(void);
+void __glcArenaDestroy(__GLCarena* This);
+void* __glcArenaAlloc(__GLCarena* This, const size_t inSize);
+void __glcArenaFree(__GLCarena* This, void* inBuffer);
+void __glcArenaReset(__GLCarena* This);
+#endif
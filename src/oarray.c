@@ -78,22 +78,27 @@ void __glcArrayDestroy(__GLCarray* This)
 
 
 
-/* Allocate a new block of elements in the array 'This'. The function returns
+/* Allocate some more room in the array 'This' so that it can store at least
+ * 'inLength' elements. The room is doubled each time it is increased so that
+ * the cost of the copies made by realloc() is amortized. The function returns
  * NULL if it fails and raises an error accordingly. However the original
  * array is not lost and is kept untouched.
  */
-static __GLCarray* __glcArrayUpdateSize(__GLCarray* This)
+static __GLCarray* __glcArrayUpdateSize(__GLCarray* This, const int inLength)
 {
   char* data = NULL;
+  int allocated = This->allocated * 2;
 
-  data = (char*)__glcRealloc(This->data,
-	(This->allocated + GLC_ARRAY_BLOCK_SIZE) * This->elementSize);
+  if (allocated < inLength)
+    allocated = inLength;
+
+  data = (char*)__glcRealloc(This->data, allocated * This->elementSize);
   if (!data) {
     __glcRaiseError(GLC_RESOURCE_ERROR);
     return NULL;
   }
   This->data = data;
-  This->allocated += GLC_ARRAY_BLOCK_SIZE;
+  This->allocated = allocated;
 
   return This;
 }
@@ -107,7 +112,7 @@ __GLCarray* __glcArrayAppend(__GLCarray* This, const void* inValue)
 {
   /* Update the room if needed */
   if (This->length == This->allocated) {
-    if (!__glcArrayUpdateSize(This))
+    if (!__glcArrayUpdateSize(This, This->length + 1))
       return NULL;
   }
 
@@ -129,7 +134,7 @@ __GLCarray* __glcArrayInsert(__GLCarray* This, const int inRank,
 {
   /* Update the room if needed */
   if (This->length == This->allocated) {
-    if (!__glcArrayUpdateSize(This))
+    if (!__glcArrayUpdateSize(This, This->length + 1))
       return NULL;
   }
 
@@ -174,10 +179,8 @@ void* __glcArrayInsertCell(__GLCarray* This, const int inRank,
 {
   char* newCell = NULL;
 
-  assert(inCells < GLC_ARRAY_BLOCK_SIZE);
-
   if ((This->length + inCells) > This->allocated) {
-    if (!__glcArrayUpdateSize(This))
+    if (!__glcArrayUpdateSize(This, This->length + inCells))
       return NULL;
   }
 
@@ -194,6 +197,48 @@ void* __glcArrayInsertCell(__GLCarray* This, const int inRank,
 
 
 
+/* Make sure that the array can store at least 'inLength' elements without
+ * reallocating its memory. It should be called whenever the number of
+ * elements that will be stored is known in advance. The function returns NULL
+ * if it fails and raises an error accordingly.
+ */
+__GLCarray* __glcArrayReserve(__GLCarray* This, const int inLength)
+{
+  if (inLength > This->allocated)
+    return __glcArrayUpdateSize(This, inLength);
+
+  return This;
+}
+
+
+
+/* Release the memory of the array that is not needed to store 'inLength'
+ * elements (or the current elements of the array if they are more). It is used
+ * to trim the arrays that are reused as scratch buffers, once an unusually
+ * large amount of data has been stored in them. If the memory can not be
+ * reallocated, the array is kept untouched.
+ */
+void __glcArrayShrink(__GLCarray* This, const int inLength)
+{
+  char* data = NULL;
+  int allocated = (This->length > inLength) ? This->length : inLength;
+
+  if (allocated < GLC_ARRAY_BLOCK_SIZE)
+    allocated = GLC_ARRAY_BLOCK_SIZE;
+
+  if (allocated >= This->allocated)
+    return;
+
+  data = (char*)__glcRealloc(This->data, allocated * This->elementSize);
+  if (!data)
+    return;
+
+  This->data = data;
+  This->allocated = allocated;
+}
+
+
+
 /* Duplicate an array */
 __GLCarray* __glcArrayDuplicate(__GLCarray* This)
 {
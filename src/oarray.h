@@ -30,6 +30,11 @@
 #define GLC_ARRAY_LENGTH(array) ((array)->length)
 #define GLC_ARRAY_SIZE(array) (((array)->length) * ((array)->elementSize))
 
+/* Number of elements above which the scratch arrays of the contexts are
+ * trimmed after use.
+ */
+#define GLC_ARRAY_HIGH_WATER 4096
+
 typedef struct __GLCarrayRec __GLCarray;
 
 struct __GLCarrayRec {
@@ -47,5 +52,7 @@ __GLCarray* __glcArrayInsert(__GLCarray* This, const int inRank,
 void __glcArrayRemove(__GLCarray* This, const int inRank);
 void* __glcArrayInsertCell(__GLCarray* This, const int inRank,
 			   const int inCells);
+__GLCarray* __glcArrayReserve(__GLCarray* This, const int inLength);
+void __glcArrayShrink(__GLCarray* This, const int inLength);
 __GLCarray* __glcArrayDuplicate(__GLCarray* This);
 #endif
@@ -31,12 +31,17 @@
 
 #include "internal.h"
 #include "texture.h"
+#if defined __APPLE__ && defined __MACH__
+#include <OpenGL/glu.h>
+#else
+#include <GL/glu.h>
+#endif
 #include FT_MODULE_H
 
 __GLCcommonArea __glcCommonArea;
 #ifdef HAVE_TLS
 __thread __GLCthreadArea __glcTlsThreadArea;
-#else
+#elif defined(__WIN32__)
 __GLCthreadArea* __glcThreadArea = NULL;
 #endif
 
@@ -68,6 +73,26 @@ static GLCchar8* __glcFindIndexList(GLCchar8* inString, const GLuint inIndex,
 
 
 
+/* Add the fonts of a catalog to the Fontconfig configuration of the context.
+ * Fontconfig scans the directory and may update its cache files, so the call
+ * is serialized. Only the calls which modify the configuration are locked :
+ * the queries of __glcContextUpdateHashTable() only read the configuration
+ * which is private to the context.
+ */
+static FcBool __glcContextAddFontDir(__GLCcontext* This,
+				     const GLCchar8* inCatalog)
+{
+  FcBool result = FcFalse;
+
+  __glcLockFontconfig();
+  result = FcConfigAppFontAddDir(This->config, inCatalog);
+  __glcUnlockFontconfig();
+
+  return result;
+}
+
+
+
 /* Constructor of the object : it allocates memory and initializes the member
  * of the new object.
  */
@@ -100,9 +125,9 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
   }
 #endif
 
-  __glcLock();
+  __glcLockFontconfig();
   This->config = FcInitLoadConfigAndFonts();
-  __glcUnlock();
+  __glcUnlockFontconfig();
   if (!This->config) {
     __glcRaiseError(GLC_RESOURCE_ERROR);
 #ifdef GLC_FT_CACHE
@@ -154,8 +179,10 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
   This->fontList.tail = NULL;
   This->genFontList.head = NULL;
   This->genFontList.tail = NULL;
+  This->textList.head = NULL;
+  This->textList.tail = NULL;
 
-  This->isCurrent = GL_FALSE;
+  This->state = GLC_CONTEXT_RELEASED;
   This->isInGlobalCommand = GL_FALSE;
   This->id = inContext;
   This->pendingDelete = GL_FALSE;
@@ -168,6 +195,7 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
   This->enableState.hinting = GL_FALSE;
   This->enableState.extrude = GL_FALSE;
   This->enableState.kerning = GL_FALSE;
+  This->enableState.stringCache = GL_FALSE;
   This->renderState.resolution = 72.;
   This->renderState.renderStyle = GLC_BITMAP;
   This->renderState.tolerance = 0.005;
@@ -201,8 +229,8 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
     __glcFree(This);
     return NULL;
   }
-  This->controlPoints = __glcArrayCreate(5 * sizeof(GLfloat));
-  if (!This->controlPoints) {
+  This->endContour = __glcArrayCreate(sizeof(int));
+  if (!This->endContour) {
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
@@ -215,9 +243,10 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
     __glcFree(This);
     return NULL;
   }
-  This->endContour = __glcArrayCreate(sizeof(int));
-  if (!This->endContour) {
-    __glcArrayDestroy(This->controlPoints);
+
+  This->vertexIndices = __glcArrayCreate(sizeof(GLuint));
+  if (!This->vertexIndices) {
+    __glcArrayDestroy(This->endContour);
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
@@ -231,10 +260,10 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
     return NULL;
   }
 
-  This->vertexIndices = __glcArrayCreate(sizeof(GLuint));
-  if (!This->vertexIndices) {
+  This->geomBatches = __glcArrayCreate(sizeof(__GLCgeomBatch));
+  if (!This->geomBatches) {
+    __glcArrayDestroy(This->vertexIndices);
     __glcArrayDestroy(This->endContour);
-    __glcArrayDestroy(This->controlPoints);
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
@@ -248,11 +277,81 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
     return NULL;
   }
 
-  This->geomBatches = __glcArrayCreate(sizeof(__GLCgeomBatch));
-  if (!This->geomBatches) {
+  This->tesselator = __glcTesselatorCreate();
+  if (!This->tesselator) {
+    __glcArrayDestroy(This->geomBatches);
+    __glcArrayDestroy(This->vertexIndices);
+    __glcArrayDestroy(This->endContour);
+    __glcArrayDestroy(This->vertexArray);
+    __glcArrayDestroy(This->measurementBuffer);
+    __glcArrayDestroy(This->masterHashTable);
+    __glcArrayDestroy(This->catalogList);
+#ifdef GLC_FT_CACHE
+    FTC_Manager_Done(This->cache);
+#endif
+    FT_Done_Library(This->library);
+    FcConfigDestroy(This->config);
+    __glcFree(This);
+    return NULL;
+  }
+
+  This->arena = __glcArenaCreate();
+  if (!This->arena) {
+    gluDeleteTess(This->tesselator);
+    __glcArrayDestroy(This->geomBatches);
+    __glcArrayDestroy(This->vertexIndices);
+    __glcArrayDestroy(This->endContour);
+    __glcArrayDestroy(This->vertexArray);
+    __glcArrayDestroy(This->measurementBuffer);
+    __glcArrayDestroy(This->masterHashTable);
+    __glcArrayDestroy(This->catalogList);
+#ifdef GLC_FT_CACHE
+    FTC_Manager_Done(This->cache);
+#endif
+    FT_Done_Library(This->library);
+    FcConfigDestroy(This->config);
+    __glcFree(This);
+    return NULL;
+  }
+
+  This->glyphPool = __glcPoolCreate(sizeof(__GLCglyph));
+  This->atlasPool = __glcPoolCreate(sizeof(__GLCatlasElement));
+  This->nodePool = __glcPoolCreate(sizeof(FT_ListNodeRec));
+  if (!This->glyphPool || !This->atlasPool || !This->nodePool) {
+    if (This->nodePool)
+      __glcPoolDestroy(This->nodePool);
+    if (This->atlasPool)
+      __glcPoolDestroy(This->atlasPool);
+    if (This->glyphPool)
+      __glcPoolDestroy(This->glyphPool);
+    __glcArenaDestroy(This->arena);
+    gluDeleteTess(This->tesselator);
+    __glcArrayDestroy(This->geomBatches);
+    __glcArrayDestroy(This->vertexIndices);
+    __glcArrayDestroy(This->endContour);
+    __glcArrayDestroy(This->vertexArray);
+    __glcArrayDestroy(This->measurementBuffer);
+    __glcArrayDestroy(This->masterHashTable);
+    __glcArrayDestroy(This->catalogList);
+#ifdef GLC_FT_CACHE
+    FTC_Manager_Done(This->cache);
+#endif
+    FT_Done_Library(This->library);
+    FcConfigDestroy(This->config);
+    __glcFree(This);
+    return NULL;
+  }
+
+  This->stringCache = __glcStringCacheCreate();
+  if (!This->stringCache) {
+    __glcPoolDestroy(This->nodePool);
+    __glcPoolDestroy(This->atlasPool);
+    __glcPoolDestroy(This->glyphPool);
+    __glcArenaDestroy(This->arena);
+    gluDeleteTess(This->tesselator);
+    __glcArrayDestroy(This->geomBatches);
     __glcArrayDestroy(This->vertexIndices);
     __glcArrayDestroy(This->endContour);
-    __glcArrayDestroy(This->controlPoints);
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
@@ -333,8 +432,7 @@ __GLCcontext* __glcContextCreate(const GLint inContext)
         else {
 	  if (!__glcArrayAppend(This->catalogList, &duplicated))
             free(duplicated);
-          else if (!FcConfigAppFontAddDir(This->config,
-                                          (const unsigned char*)begin)) {
+          else if (!__glcContextAddFontDir(This, begin)) {
             __glcArrayRemove(This->catalogList,
                              GLC_ARRAY_LENGTH(This->catalogList));
 	    __glcRaiseError(GLC_RESOURCE_ERROR);
@@ -408,6 +506,7 @@ static void __glcFontDestructor(FT_Memory GLC_UNUSED_ARG(inMemory),
 void __glcContextDestroy(__GLCcontext *This)
 {
   int i = 0;
+  FT_ListNode node = NULL;
 
   assert(This);
 
@@ -423,37 +522,46 @@ void __glcContextDestroy(__GLCcontext *This)
   /* Destroy GLC_CURRENT_FONT_LIST */
 #ifdef GLC_FT_CACHE
   FT_List_Finalize(&This->currentFontList, NULL,
-		   &__glcCommonArea.memoryManager, NULL);
+		   &This->nodePool->memory, NULL);
 #else
   FT_List_Finalize(&This->currentFontList, __glcFontClosure,
-		   &__glcCommonArea.memoryManager, NULL);
+		   &This->nodePool->memory, NULL);
 #endif
 
   /* Destroy GLC_FONT_LIST */
   FT_List_Finalize(&This->fontList, __glcFontDestructor,
-                   &__glcCommonArea.memoryManager, This);
+                   &This->nodePool->memory, This);
   /* Destroy empty fonts generated by glcGenFontID() */
   FT_List_Finalize(&This->genFontList, __glcFontDestructor,
-		   &__glcCommonArea.memoryManager, This);
+		   &This->nodePool->memory, This);
+
+  /* Destroy the text objects generated by glcGenTextQSO() */
+  node = This->textList.head;
+  while (node) {
+    FT_ListNode next = node->next;
+
+    __glcTextDestroy((__GLCtext*)node, This);
+    node = next;
+  }
 
   if (This->masterHashTable)
     __glcArrayDestroy(This->masterHashTable);
 
-  FT_List_Finalize(&This->atlasList, NULL,
-		   &__glcCommonArea.memoryManager, NULL);
-
   if (This->bufferSize)
     __glcFree(This->buffer);
 
   if (This->measurementBuffer)
     __glcArrayDestroy(This->measurementBuffer);
 
+  if (This->paragraphString)
+    __glcArrayDestroy(This->paragraphString);
+
+  if (This->paragraphLines)
+    __glcArrayDestroy(This->paragraphLines);
+
   if (This->vertexArray)
     __glcArrayDestroy(This->vertexArray);
 
-  if (This->controlPoints)
-    __glcArrayDestroy(This->controlPoints);
-
   if (This->endContour)
     __glcArrayDestroy(This->endContour);
 
@@ -463,6 +571,27 @@ void __glcContextDestroy(__GLCcontext *This)
   if (This->geomBatches)
     __glcArrayDestroy(This->geomBatches);
 
+  if (This->tesselator)
+    gluDeleteTess(This->tesselator);
+
+  if (This->arena)
+    __glcArenaDestroy(This->arena);
+
+  if (This->stringCache)
+    __glcStringCacheDestroy(This->stringCache);
+
+  /* The nodes of the lists and the glyphs have already been released but the
+   * elements of the texture atlas are released at once with their pool.
+   */
+  if (This->nodePool)
+    __glcPoolDestroy(This->nodePool);
+
+  if (This->atlasPool)
+    __glcPoolDestroy(This->atlasPool);
+
+  if (This->glyphPool)
+    __glcPoolDestroy(This->glyphPool);
+
 #ifdef GLC_FT_CACHE
   FTC_Manager_Done(This->cache);
 #endif
@@ -757,7 +886,7 @@ void __glcContextAppendCatalog(__GLCcontext* This, const GLCchar* inCatalog)
     return;
   }
 
-  if (!FcConfigAppFontAddDir(This->config, (const unsigned char*)inCatalog)) {
+  if (!__glcContextAddFontDir(This, (const GLCchar8*)inCatalog)) {
     __glcArrayRemove(This->catalogList, GLC_ARRAY_LENGTH(This->catalogList));
     __glcRaiseError(GLC_RESOURCE_ERROR);
     free(duplicated);
@@ -794,7 +923,7 @@ void __glcContextPrependCatalog(__GLCcontext* This, const GLCchar* inCatalog)
     return;
   }
 
-  if (!FcConfigAppFontAddDir(This->config, (const unsigned char*)inCatalog)) {
+  if (!__glcContextAddFontDir(This, (const GLCchar8*)inCatalog)) {
     __glcArrayRemove(This->catalogList, 0);
     __glcRaiseError(GLC_RESOURCE_ERROR);
     free(duplicated);
@@ -843,9 +972,10 @@ void __glcContextDeleteFont(__GLCcontext* inContext, __GLCfont* font)
 #ifndef GLC_FT_CACHE
     __glcFontClose(font);
 #endif
-    __glcFree(node);
+    __glcPoolFree(inContext->nodePool, node);
   }
   __glcFontDestroy(font, inContext);
+  __glcStringCacheInvalidate(inContext->stringCache);
 }
 
 
@@ -862,7 +992,9 @@ void __glcContextRemoveCatalog(__GLCcontext* This, const GLint inIndex)
     return;
   }
 
+  __glcLockFontconfig();
   FcConfigAppFontClear(This->config);
+  __glcUnlockFontconfig();
   catalog = ((GLCchar8**)GLC_ARRAY_DATA(This->catalogList))[inIndex];
   assert(catalog);
   __glcArrayRemove(This->catalogList, inIndex);
@@ -871,7 +1003,7 @@ void __glcContextRemoveCatalog(__GLCcontext* This, const GLint inIndex)
   for (i = 0; i < GLC_ARRAY_LENGTH(This->catalogList); i++) {
     catalog = ((GLCchar8**)GLC_ARRAY_DATA(This->catalogList))[i];
     assert(catalog);
-    if (!FcConfigAppFontAddDir(This->config, catalog)) {
+    if (!__glcContextAddFontDir(This, catalog)) {
       __glcRaiseError(GLC_RESOURCE_ERROR);
       __glcArrayRemove(This->catalogList, i);
       free(catalog);
@@ -39,10 +39,62 @@
 #include FT_LIST_H
 
 #include "oarray.h"
+#include "oarena.h"
+#include "opool.h"
+#include "ostrcache.h"
 #include "except.h"
 
 #define GLC_MAX_MATRIX_STACK_DEPTH	32
 #define GLC_MAX_ATTRIB_STACK_DEPTH	16
+#define GLC_CONTEXT_TABLE_SIZE		16
+#define GLC_STAT_COUNT			14
+#define GLC_MEMORY_STAT_COUNT		4
+#define GLC_STAT_MAX			0x7fffffff
+
+/* Access the performance counter 'stat' of GLC_QSO_stats. The counters are not
+ * part of the state of the context, hence the cast which allows to update them
+ * from the functions which are given a const context.
+ */
+#define GLC_STAT(ctx, stat)						\
+  (((__GLCcontext*)(ctx))->stats[(stat) - GLC_CHARMAP_HIT_COUNT_QSO])
+#define GLC_STAT_ADD(ctx, stat, value)					\
+  __glcStatAdd(&GLC_STAT(ctx, stat), (GLuint)(value))
+#define GLC_STAT_INC(ctx, stat) GLC_STAT_ADD(ctx, stat, 1)
+
+/* States of a context. A context is made current by switching its state from
+ * GLC_CONTEXT_RELEASED to GLC_CONTEXT_CURRENT and it can only be destroyed by
+ * the thread that switches its state from GLC_CONTEXT_RELEASED to
+ * GLC_CONTEXT_DELETED.
+ */
+#define GLC_CONTEXT_RELEASED	0
+#define GLC_CONTEXT_CURRENT	1
+#define GLC_CONTEXT_DELETED	2
+
+/* Number of entries of the cache of thread areas (see __glcGetThreadArea()) */
+#define GLC_THREAD_CACHE_BITS	6
+#define GLC_THREAD_CACHE_SIZE	(1 << GLC_THREAD_CACHE_BITS)
+
+/* Atomic operations on the variables that are shared between threads without
+ * locking the common area. They also act as full memory barriers.
+ */
+#ifdef __WIN32__
+#define GLC_ATOMIC_CAS(ptr, oldValue, newValue)				\
+  (InterlockedCompareExchange((LONG volatile*)(ptr), (LONG)(newValue),	\
+			      (LONG)(oldValue)) == (LONG)(oldValue))
+#define GLC_ATOMIC_CAS_PTR(ptr, oldValue, newValue)			\
+  (InterlockedCompareExchangePointer((PVOID volatile*)(ptr),		\
+				     (PVOID)(newValue), (PVOID)(oldValue))	\
+   == (PVOID)(oldValue))
+#define GLC_ATOMIC_INC(ptr) InterlockedIncrement((LONG volatile*)(ptr))
+#define GLC_ATOMIC_DEC(ptr) InterlockedDecrement((LONG volatile*)(ptr))
+#else
+#define GLC_ATOMIC_CAS(ptr, oldValue, newValue)				\
+  __sync_bool_compare_and_swap((ptr), (oldValue), (newValue))
+#define GLC_ATOMIC_CAS_PTR(ptr, oldValue, newValue)			\
+  __sync_bool_compare_and_swap((ptr), (oldValue), (newValue))
+#define GLC_ATOMIC_INC(ptr) __sync_add_and_fetch((ptr), 1)
+#define GLC_ATOMIC_DEC(ptr) __sync_sub_and_fetch((ptr), 1)
+#endif
 
 typedef struct __GLCcontextRec __GLCcontext;
 typedef struct __GLCtextureRec __GLCtexture;
@@ -54,11 +106,14 @@ typedef struct __GLCattribStackLevelRec  __GLCattribStackLevel;
 typedef struct __GLCthreadAreaRec __GLCthreadArea;
 typedef struct __GLCcommonAreaRec  __GLCcommonArea;
 typedef struct __GLCfontRec __GLCfont;
+typedef struct __GLCthreadCacheEntryRec __GLCthreadCacheEntry;
+typedef struct __GLCcontextTableRec __GLCcontextTable;
 
 struct __GLCtextureRec {
   GLuint id;
   GLsizei width;
   GLsizei height;
+  GLint format;			/* Internal format of the texture */
   GLuint bufferObjectID;
 };
 
@@ -69,6 +124,7 @@ struct __GLCenableStateRec {
   GLboolean hinting;		/* GLC_HINTING_QSO */
   GLboolean extrude;		/* GLC_EXTRUDE_QSO */
   GLboolean kerning;		/* GLC_KERNING_QSO */
+  GLboolean stringCache;	/* GLC_STRING_CACHE_QSO */
 };
 
 struct __GLCrenderStateRec {
@@ -91,6 +147,9 @@ struct __GLCglStateRec {
   GLint vertexBufferObjectID;
   GLint elementBufferObjectID;
   GLboolean blend;
+  GLboolean alphaTest;
+  GLboolean fragmentProgram;
+  GLint fragmentProgramID;
   GLboolean normalize;
   GLboolean vertexArray;
   GLboolean normalArray;
@@ -100,6 +159,8 @@ struct __GLCglStateRec {
   GLboolean edgeFlagArray;
   GLint blendSrc;
   GLint blendDst;
+  GLint alphaFunc;
+  GLfloat alphaRef;
   GLint vertexArraySize;
   GLint vertexArrayType;
   GLint vertexArrayStride;
@@ -139,22 +200,31 @@ struct __GLCcontextRec {
 
   GLint id;			/* Context ID */
   GLboolean isInGlobalCommand;	/* Is in a global command ? */
-  GLboolean pendingDelete;	/* Is there a pending deletion ? */
+  volatile GLboolean pendingDelete;	/* Is there a pending deletion ? */
   __GLCenableState enableState;
   __GLCrenderState renderState;
   __GLCstringState stringState;
   FT_ListRec currentFontList;	/* GLC_CURRENT_FONT_LIST */
   FT_ListRec fontList;		/* GLC_FONT_LIST */
   FT_ListRec genFontList;       /* Fonts generated by glcGenFontID() */
+  FT_ListRec textList;		/* Text objects of glcGenTextQSO() */
   __GLCarray* masterHashTable;
   __GLCarray* catalogList;	/* GLC_CATALOG_LIST */
   __GLCarray* measurementBuffer;
   GLfloat measurementStringBuffer[12];
+  __GLCarray* paragraphString;	/* Characters of glcLayoutParagraphQSO() */
+  __GLCarray* paragraphLines;	/* Lines of glcLayoutParagraphQSO() */
+  GLboolean paragraphIsRTL;	/* Is the paragraph right to left ? */
   __GLCarray* vertexArray;	/* Array of vertices */
-  __GLCarray* controlPoints;	/* Array of control points */
   __GLCarray* endContour;	/* Array of contour limits */
   __GLCarray* vertexIndices;	/* Array of vertex indices */
   __GLCarray* geomBatches;	/* Array of geometric batches */
+  struct GLUtesselator* tesselator; /* Fallback tesselator of GLC_TRIANGLE */
+  __GLCarena* arena;		/* Transient buffers of the GLC commands */
+  __GLCpool* glyphPool;		/* Glyphs of the fonts */
+  __GLCpool* atlasPool;		/* Elements of the texture atlas */
+  __GLCpool* nodePool;		/* Nodes of the font lists */
+  __GLCstringCache* stringCache;	/* Strings recently rendered or measured */
 
 #ifdef GLEW_MX
   GLEWContext glewContext;	/* GLEW context for OpenGL extensions */
@@ -166,6 +236,9 @@ struct __GLCcontextRec {
   int atlasWidth;
   int atlasHeight;
   int atlasCount;
+  int atlasPinCount;		/* Pins of the atlas by the text objects */
+  GLCenum atlasStyle;		/* Render style of the glyphs in the atlas */
+  GLuint sdfProgramID;		/* Fragment program of GLC_SDF_QSO */
 
   GLfloat* bitmapMatrix;	/* GLC_BITMAP_MATRIX */
   GLfloat bitmapMatrixStack[4*GLC_MAX_MATRIX_STACK_DEPTH];
@@ -174,7 +247,9 @@ struct __GLCcontextRec {
   __GLCattribStackLevel attribStack[GLC_MAX_ATTRIB_STACK_DEPTH];
   GLint attribStackDepth;
 
-  GLboolean isCurrent;
+  GLuint stats[GLC_STAT_COUNT];	/* Performance counters of GLC_QSO_stats */
+
+  volatile GLint state;		/* GLC_CONTEXT_RELEASED/CURRENT/DELETED */
   GLboolean isInCallbackFunc;	/* Is a callback function executing ? */
 };
 
@@ -186,21 +261,50 @@ struct __GLCthreadAreaRec {
   __glcException failedTry;
 };
 
+/* An entry of the cache of thread areas. An entry is owned by the thread
+ * which ID is stored in 'owner' : 'area' is only written and read by that
+ * thread so the other threads only need to read 'owner'.
+ */
+struct __GLCthreadCacheEntryRec {
+  volatile size_t owner;	/* ID of the owner thread, 0 if unused */
+  __GLCthreadArea* area;
+};
+
+/* The table of the contexts. Its size is doubled when it is full : a larger
+ * copy is published and the old table is retired until no thread can read it
+ * anymore.
+ */
+struct __GLCcontextTableRec {
+  __GLCcontextTable* next;	/* Next table in the list of retired tables */
+  GLint size;			/* Number of entries */
+  __GLCcontext* volatile entries[1];
+};
+
 struct __GLCcommonAreaRec {
   GLint versionMajor;		/* GLC_VERSION_MAJOR */
   GLint versionMinor;		/* GLC_VERSION_MINOR */
 
-  FT_ListRec contextList;
+  /* The context of ID 'i' is stored in contextTable->entries[i-1]. The table
+   * is read without locking the common area, so a context that is removed
+   * from the table is moved to deletedContextList and a table that has been
+   * replaced by a larger one is moved to retiredContextTables. They are only
+   * destroyed once no thread is reading the table anymore.
+   */
+  __GLCcontextTable* volatile contextTable;
+  volatile GLint contextReaders;	/* Threads that are reading the table */
+  FT_ListRec deletedContextList;
+  __GLCcontextTable* retiredContextTables;
 #ifndef __WIN32__
   pthread_mutex_t mutex;	/* For concurrent accesses to the common
 				   area */
+  pthread_mutex_t fontconfigMutex; /* For calls to Fontconfig */
 #ifndef HAVE_TLS
   pthread_key_t threadKey;
-  pthread_t threadID;
-  pthread_once_t __glcInitThreadOnce;
+  __GLCthreadCacheEntry threadCache[GLC_THREAD_CACHE_SIZE];
 #endif /* HAVE_TLS */
 #else /* __WIN32__ */
   CRITICAL_SECTION section;
+  CRITICAL_SECTION fontconfigSection;
   DWORD threadKey;
   DWORD threadID;
   LONG __glcInitThreadOnce;
@@ -218,7 +322,7 @@ extern __GLCcommonArea __glcCommonArea;
 #ifdef HAVE_TLS
 extern __thread __GLCthreadArea __glcTlsThreadArea
     __attribute__((tls_model("initial-exec")));
-#else
+#elif defined(__WIN32__)
 extern __GLCthreadArea* __glcThreadArea;
 #endif
 
@@ -232,4 +336,15 @@ void __glcContextRemoveCatalog(__GLCcontext* This, const GLint inIndex);
 GLCchar8* __glcContextGetCatalogPath(const __GLCcontext* This,
 				     const GLint inIndex);
 void __glcContextDeleteFont(__GLCcontext* inContext, __GLCfont* font);
+
+/* Add 'inValue' to a performance counter. The counters saturate at
+ * GLC_STAT_MAX so that they can always be returned by glcGeti().
+ */
+static inline void __glcStatAdd(GLuint* inStat, const GLuint inValue)
+{
+  if (inValue > GLC_STAT_MAX - *inStat)
+    *inStat = GLC_STAT_MAX;
+  else
+    *inStat += inValue;
+}
 #endif /* __glc_ocontext_h */
@@ -36,6 +36,9 @@
 #include FT_CACHE_H
 #endif
 #include FT_OUTLINE_H
+#ifdef FT_ADVANCES_H
+#include FT_ADVANCES_H
+#endif
 
 #include FT_TYPE1_TABLES_H
 #ifdef FT_XFREE86_H
@@ -47,6 +50,8 @@
 #endif
 #include FT_SFNT_NAMES_H
 #include FT_TRUETYPE_IDS_H
+#include FT_TRUETYPE_TABLES_H
+#include FT_TRUETYPE_TAGS_H
 
 
 
@@ -184,6 +189,9 @@ __GLCfaceDescriptor* __glcFaceDescCreate(const __GLCmaster* inMaster,
     return NULL;
   }
 
+  /* The kerning pairs are read the first time that they are needed */
+  This->kerningCount = -1;
+
   return This;
 }
 
@@ -205,7 +213,7 @@ void __glcFaceDescDestroy(__GLCfaceDescriptor* This, __GLCcontext* inContext)
   node = This->glyphList.head;
   while (node) {
     next = node->next;
-    __glcGlyphDestroy((__GLCglyph*)node, inContext);
+    __glcGlyphDestroy((__GLCglyph*)node->data, inContext);
     node = next;
   }
 
@@ -218,6 +226,26 @@ void __glcFaceDescDestroy(__GLCfaceDescriptor* This, __GLCcontext* inContext)
   FTC_Manager_RemoveFaceID(inContext->cache, (FTC_FaceID)This);
 #endif
 
+  if (This->kerningPairs)
+    __glcFree(This->kerningPairs);
+
+  if (This->advancePages) {
+    GLint i = 0;
+
+    for (i = 0; i < This->advancePageCount; i++) {
+      if (This->advancePages[i])
+	__glcFree(This->advancePages[i]);
+    }
+    __glcFree(This->advancePages);
+  }
+
+  if (This->records.advance)
+    __glcFree(This->records.advance);
+  if (This->records.atlasRect)
+    __glcFree(This->records.atlasRect);
+  if (This->records.atlasVertex)
+    __glcFree(This->records.atlasVertex);
+
   FcPatternDestroy(This->pattern);
   __glcFree(This);
 }
@@ -328,6 +356,51 @@ FT_Error __glcFileOpen(FTC_FaceID inFile, FT_Library inLibrary,
 
 
 
+/* Make room for one more render record in the records of the face. The
+ * arrays of the records are grown by doubling their size so that the records
+ * of the glyphs of a face remain contiguous.
+ */
+static GLboolean __glcFaceDescReserveRecord(__GLCfaceDescriptor* This)
+{
+  __GLCrenderRecords* records = &This->records;
+
+  if (records->count == records->size) {
+    GLint size = records->size ? records->size * 2 : 64;
+    GLfloat (*advance)[2] = NULL;
+    GLfloat (*atlasRect)[8] = NULL;
+    GLint* atlasVertex = NULL;
+
+    advance = (GLfloat(*)[2])__glcRealloc(records->advance,
+					  size * sizeof(GLfloat[2]));
+    if (!advance) {
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      return GL_FALSE;
+    }
+    records->advance = advance;
+
+    atlasRect = (GLfloat(*)[8])__glcRealloc(records->atlasRect,
+					    size * sizeof(GLfloat[8]));
+    if (!atlasRect) {
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      return GL_FALSE;
+    }
+    records->atlasRect = atlasRect;
+
+    atlasVertex = (GLint*)__glcRealloc(records->atlasVertex,
+				       size * sizeof(GLint));
+    if (!atlasVertex) {
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      return GL_FALSE;
+    }
+    records->atlasVertex = atlasVertex;
+    records->size = size;
+  }
+
+  return GL_TRUE;
+}
+
+
+
 /* Return the glyph which corresponds to codepoint 'inCode' */
 __GLCglyph* __glcFaceDescGetGlyph(__GLCfaceDescriptor* This,
 				  const GLint inCode,
@@ -340,11 +413,15 @@ __GLCglyph* __glcFaceDescGetGlyph(__GLCfaceDescriptor* This,
 
   /* Check if the glyph has already been added to the glyph list */
   for (node = This->glyphList.head; node; node = node->next) {
-    glyph = (__GLCglyph*)node;
-    if (glyph->codepoint == (GLCulong)inCode)
+    glyph = (__GLCglyph*)node->data;
+    if (glyph->codepoint == (GLCulong)inCode) {
+      GLC_STAT_INC(inContext, GLC_GLYPH_LIST_HIT_COUNT_QSO);
       return glyph;
+    }
   }
 
+  GLC_STAT_INC(inContext, GLC_GLYPH_LIST_MISS_COUNT_QSO);
+
   /* Open the face */
 #ifdef GLC_FT_CACHE
   if (FTC_Manager_LookupFace(inContext->cache, (FTC_FaceID)This, &face)) {
@@ -364,17 +441,24 @@ __GLCglyph* __glcFaceDescGetGlyph(__GLCfaceDescriptor* This,
 #endif
   if (!index)
     return NULL;
-  glyph = __glcGlyphCreate(index, inCode);
-  if (!glyph) {
+  if (!__glcFaceDescReserveRecord(This)
+      || !(glyph = __glcGlyphCreate(index, inCode, inContext))) {
 #ifndef GLC_FT_CACHE
     __glcFaceDescClose(This);
 #endif
     return NULL;
   }
+
+  /* Attach the render record of the new glyph */
+  glyph->records = &This->records;
+  glyph->record = This->records.count++;
+  This->records.advance[glyph->record][0] = 0.f;
+  This->records.advance[glyph->record][1] = 0.f;
+  This->records.atlasVertex[glyph->record] = -1;
   /* Append the new glyph to the list of the glyphes of the face and close the
    * face.
    */
-  FT_List_Add(&This->glyphList, (FT_ListNode)glyph);
+  FT_List_Add(&This->glyphList, &glyph->node);
 #ifndef GLC_FT_CACHE
   __glcFaceDescClose(This);
 #endif
@@ -498,6 +582,7 @@ GLboolean __glcFaceDescPrepareGlyph(__GLCfaceDescriptor* This,
     loadFlags |= FT_LOAD_NO_HINTING;
 
   /* Load the glyph */
+  GLC_STAT_INC(inContext, GLC_GLYPH_LOAD_COUNT_QSO);
   if (FT_Load_Glyph(This->face, inGlyphIndex, loadFlags)) {
     __glcRaiseError(GLC_RESOURCE_ERROR);
 #ifndef GLC_FT_CACHE
@@ -518,7 +603,7 @@ void __glcFaceDescDestroyGLObjects(const __GLCfaceDescriptor* This,
   FT_ListNode node = NULL;
 
   for (node = This->glyphList.head; node; node = node->next) {
-    __GLCglyph* glyph = (__GLCglyph*)node;
+    __GLCglyph* glyph = (__GLCglyph*)node->data;
 
     __glcGlyphDestroyGLObjects(glyph, inContext);
   }
@@ -595,6 +680,158 @@ GLfloat* __glcFaceDescGetAdvance(__GLCfaceDescriptor* This,
 
 
 
+/* Get the advance and the bounding box of a glyph in font units. The glyph is
+ * loaded unscaled hence unhinted, so the values do not depend on the size nor
+ * on the resolution and can be cached once for all. 'inGlyphIndex' contains
+ * the index of the glyph in the font file.
+ */
+GLboolean __glcFaceDescGetUnscaledMetrics(__GLCfaceDescriptor* This,
+					  const GLCulong inGlyphIndex,
+					  GLint* outAdvance,
+					  GLint* outBoundingBox,
+					  const __GLCcontext* inContext)
+{
+  FT_BBox boundBox;
+
+  assert(outAdvance);
+  assert(outBoundingBox);
+
+  /* The size is irrelevant for an unscaled glyph but the face must be opened
+   * anyway.
+   */
+  if (!__glcFaceDescPrepareFont(This, inContext, GLC_POINT_SIZE,
+				GLC_POINT_SIZE))
+    return GL_FALSE;
+
+  GLC_STAT_INC(inContext, GLC_GLYPH_LOAD_COUNT_QSO);
+  if (FT_Load_Glyph(This->face, inGlyphIndex, FT_LOAD_NO_SCALE
+		    | FT_LOAD_NO_BITMAP | FT_LOAD_IGNORE_TRANSFORM)) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+#ifndef GLC_FT_CACHE
+    __glcFaceDescClose(This);
+#endif
+    return GL_FALSE;
+  }
+
+  /* With FT_LOAD_NO_SCALE the metrics and the outline are in font units */
+  FT_Outline_Get_CBox(&This->face->glyph->outline, &boundBox);
+  outBoundingBox[0] = boundBox.xMin;
+  outBoundingBox[1] = boundBox.yMin;
+  outBoundingBox[2] = boundBox.xMax;
+  outBoundingBox[3] = boundBox.yMax;
+  outAdvance[0] = This->face->glyph->advance.x;
+  outAdvance[1] = This->face->glyph->advance.y;
+  This->unitsPerEM = This->face->units_per_EM;
+
+#ifndef GLC_FT_CACHE
+  __glcFaceDescClose(This);
+#endif
+  return GL_TRUE;
+}
+
+
+
+/* Get the advance of a glyph in font units. When FreeType provides
+ * FT_Get_Advances(), the advances are read by pages of GLC_ADVANCE_PAGE_SIZE
+ * consecutive glyphs and stored in a table so that the subsequent requests
+ * need neither to load the glyph nor to call FreeType. 'inGlyphIndex'
+ * contains the index of the glyph in the font file.
+ */
+GLboolean __glcFaceDescGetUnscaledAdvance(__GLCfaceDescriptor* This,
+					  const GLCulong inGlyphIndex,
+					  GLint* outAdvance,
+					  const __GLCcontext* inContext)
+{
+#ifdef FT_ADVANCES_H
+  const GLint page = inGlyphIndex / GLC_ADVANCE_PAGE_SIZE;
+  const GLint first = page * GLC_ADVANCE_PAGE_SIZE;
+  FT_Fixed advances[GLC_ADVANCE_PAGE_SIZE];
+  GLint count = 0;
+  GLint i = 0;
+
+  assert(outAdvance);
+
+  /* Fast path : the advance has already been read */
+  if ((page < This->advancePageCount) && This->advancePages[page]) {
+    outAdvance[0] = This->advancePages[page][inGlyphIndex - first];
+    outAdvance[1] = 0;
+    return GL_TRUE;
+  }
+
+  if (!__glcFaceDescPrepareFont(This, inContext, GLC_POINT_SIZE,
+				GLC_POINT_SIZE))
+    return GL_FALSE;
+
+  if (inGlyphIndex >= (GLCulong)This->face->num_glyphs) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+#ifndef GLC_FT_CACHE
+    __glcFaceDescClose(This);
+#endif
+    return GL_FALSE;
+  }
+
+  /* The table of pages is allocated the first time an advance is requested */
+  if (!This->advancePages) {
+    This->advancePageCount = (This->face->num_glyphs + GLC_ADVANCE_PAGE_SIZE
+			      - 1) / GLC_ADVANCE_PAGE_SIZE;
+    This->advancePages = (GLint**)__glcMalloc(This->advancePageCount
+					      * sizeof(GLint*));
+    if (!This->advancePages) {
+      This->advancePageCount = 0;
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+#ifndef GLC_FT_CACHE
+      __glcFaceDescClose(This);
+#endif
+      return GL_FALSE;
+    }
+    memset(This->advancePages, 0, This->advancePageCount * sizeof(GLint*));
+  }
+
+  count = This->face->num_glyphs - first;
+  if (count > GLC_ADVANCE_PAGE_SIZE)
+    count = GLC_ADVANCE_PAGE_SIZE;
+
+  /* Read the advances of the whole page. FT_LOAD_NO_SCALE returns them in font
+   * units and lets FreeType read them straight from the metrics tables of the
+   * face.
+   */
+  This->advancePages[page] = (GLint*)__glcMalloc(count * sizeof(GLint));
+  if ((!This->advancePages[page])
+      || FT_Get_Advances(This->face, first, count, FT_LOAD_NO_SCALE,
+			 advances)) {
+    if (This->advancePages[page]) {
+      __glcFree(This->advancePages[page]);
+      This->advancePages[page] = NULL;
+    }
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+#ifndef GLC_FT_CACHE
+    __glcFaceDescClose(This);
+#endif
+    return GL_FALSE;
+  }
+
+  for (i = 0; i < count; i++)
+    This->advancePages[page][i] = advances[i];
+  This->unitsPerEM = This->face->units_per_EM;
+
+#ifndef GLC_FT_CACHE
+  __glcFaceDescClose(This);
+#endif
+
+  outAdvance[0] = This->advancePages[page][inGlyphIndex - first];
+  outAdvance[1] = 0;
+  return GL_TRUE;
+#else
+  GLint boundingBox[4];
+
+  /* FT_Get_Advances() is not available : the glyph must be loaded */
+  return __glcFaceDescGetUnscaledMetrics(This, inGlyphIndex, outAdvance,
+					 boundingBox, inContext);
+#endif
+}
+
+
+
 /* Use FreeType to determine in which format the face is stored in its file :
  * Type1, TrueType, OpenType, ...
  */
@@ -762,26 +999,245 @@ GLfloat* __glcFaceDescGetMaxMetric(__GLCfaceDescriptor* This, GLfloat* outVec,
 				   const GLfloat inScaleY)
 {
   GLfloat scale = inContext->renderState.resolution / 72.;
+  GLint i = 0;
 
   assert(outVec);
 
+  /* The values are read from the header of the face once for all : they are
+   * given in font units hence they depend neither on the size nor on the
+   * resolution.
+   */
+  if (!This->maxMetricCached) {
+    if (!__glcFaceDescPrepareFont(This, inContext, inScaleX, inScaleY))
+      return NULL;
+
+    This->maxMetric[0] = This->face->max_advance_width;
+    This->maxMetric[1] = This->face->max_advance_height;
+    This->maxMetric[2] = This->face->bbox.yMax;
+    This->maxMetric[3] = This->face->bbox.yMin;
+    This->maxMetric[4] = This->face->bbox.xMax;
+    This->maxMetric[5] = This->face->bbox.xMin;
+    This->unitsPerEM = This->face->units_per_EM;
+    This->maxMetricCached = GL_TRUE;
+
+#ifndef GLC_FT_CACHE
+    __glcFaceDescClose(This);
+#endif
+  }
+
+  scale /= This->unitsPerEM;
+
+  /* Transform the values according to the resolution */
+  for (i = 0; i < 6; i++)
+    outVec[i] = (GLfloat)This->maxMetric[i] * scale;
+
+  return outVec;
+}
+
+
+
+#define GLC_KERN_USHORT(p) ((FT_UShort)(((p)[0] << 8) | (p)[1]))
+
+/* Kerning pair while the 'kern' table is read : 'order' is the index of its
+ * subtable shifted by one bit, the lowest bit is set if the subtable overrides
+ * the values of the previous ones.
+ */
+typedef struct {
+  GLuint pair;
+  GLint value;
+  GLint order;
+} __GLCkerningEntry;
+
+
+
+/* Compare two kerning entries (used by qsort) */
+static int __glcKerningEntryCompare(const void* inEntry1, const void* inEntry2)
+{
+  const __GLCkerningEntry* entry1 = (const __GLCkerningEntry*)inEntry1;
+  const __GLCkerningEntry* entry2 = (const __GLCkerningEntry*)inEntry2;
+
+  if (entry1->pair != entry2->pair)
+    return (entry1->pair < entry2->pair) ? -1 : 1;
+
+  return entry1->order - entry2->order;
+}
+
+
+
+/* Read the kerning pairs of the 'kern' table 'inTable' and store them in
+ * This->kerningPairs sorted by pair of glyph indices. Only the horizontal
+ * subtables of format 0 are read since they are the only ones which are used
+ * by FreeType : the values are the same than the ones of FT_Get_Kerning() but
+ * they are kept in font units so that they are scaled when they are looked up.
+ */
+static GLboolean __glcFaceDescReadKerningTable(__GLCfaceDescriptor* This,
+					       const FT_Byte* inTable,
+					       const FT_ULong inLength)
+{
+  const FT_Byte* limit = inTable + inLength;
+  const FT_Byte* p = NULL;
+  __GLCkerningEntry* entries = NULL;
+  GLint count = 0;
+  GLint pass = 0;
+  GLint i = 0;
+  GLint j = 0;
+
+  /* Only the version 0 of the table is supported (this is the one which is
+   * used by Microsoft, the version 1 of Apple is ignored by FreeType).
+   */
+  if ((inLength < 4) || GLC_KERN_USHORT(inTable))
+    return GL_TRUE;
+
+  /* The first pass counts the pairs and the second one reads them */
+  for (pass = 0; pass < 2; pass++) {
+    GLint nTables = GLC_KERN_USHORT(inTable + 2);
+    GLint subtable = 0;
+
+    p = inTable + 4;
+    count = 0;
+
+    for (subtable = 0; (subtable < nTables) && (p + 6 <= limit); subtable++) {
+      const FT_Byte* next = p + GLC_KERN_USHORT(p + 2);
+      FT_UShort coverage = GLC_KERN_USHORT(p + 4);
+
+      if ((next <= p + 6) || (next > limit))
+	next = limit;
+
+      /* Horizontal subtable of format 0 which is not a minimum value table
+       * and which is not cross-stream.
+       */
+      if (((coverage & ~8) == 0x0001) && (p + 14 <= next)) {
+	GLint nPairs = GLC_KERN_USHORT(p + 6);
+	const FT_Byte* pair = p + 14;
+
+	if (nPairs > (next - pair) / 6)
+	  nPairs = (GLint)((next - pair) / 6);
+
+	if (pass) {
+	  for (i = 0; i < nPairs; i++, pair += 6) {
+	    entries[count + i].pair = ((GLuint)GLC_KERN_USHORT(pair) << 16)
+	      | GLC_KERN_USHORT(pair + 2);
+	    entries[count + i].value = (FT_Short)GLC_KERN_USHORT(pair + 4);
+	    entries[count + i].order = (subtable << 1) | ((coverage & 8) >> 3);
+	  }
+	}
+	count += nPairs;
+      }
+
+      p = next;
+    }
+
+    if (!count)
+      return GL_TRUE;
+
+    if (!pass) {
+      entries = (__GLCkerningEntry*)__glcMalloc(count
+						* sizeof(__GLCkerningEntry));
+      if (!entries) {
+	__glcRaiseError(GLC_RESOURCE_ERROR);
+	return GL_FALSE;
+      }
+    }
+  }
+
+  qsort(entries, count, sizeof(__GLCkerningEntry), __glcKerningEntryCompare);
+
+  /* Merge the values of the pairs which are defined by several subtables */
+  for (i = 1, j = 0; i < count; i++) {
+    if (entries[i].pair == entries[j].pair) {
+      if (entries[i].order & 1)
+	entries[j].value = entries[i].value;
+      else
+	entries[j].value += entries[i].value;
+    }
+    else
+      entries[++j] = entries[i];
+  }
+  count = j + 1;
+
+  This->kerningPairs = (__GLCkerningPair*)__glcMalloc(count
+						      * sizeof(__GLCkerningPair));
+  if (!This->kerningPairs) {
+    __glcFree(entries);
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    return GL_FALSE;
+  }
+
+  for (i = 0; i < count; i++) {
+    This->kerningPairs[i].pair = entries[i].pair;
+    This->kerningPairs[i].value = entries[i].value;
+  }
+  This->kerningCount = count;
+
+  __glcFree(entries);
+  return GL_TRUE;
+}
+
+
+
+/* Store the scale of the face for the current size. The face must have been
+ * prepared by __glcFaceDescPrepareFont() for the size 'inSize'.
+ */
+static void __glcFaceDescSetKerningSize(__GLCfaceDescriptor* This,
+					const GLfloat inSize)
+{
+  This->kerningSize = inSize;
+  This->kerningScale = This->face->size->metrics.x_scale;
+  This->kerningPPEM = This->face->size->metrics.x_ppem;
+}
+
+
+
+/* Read the kerning pairs of the face. This is done once for all the first
+ * time that the kerning of the face is needed.
+ */
+static GLboolean __glcFaceDescLoadKerning(__GLCfaceDescriptor* This,
+					  const __GLCcontext* inContext,
+					  const GLfloat inScaleX,
+					  const GLfloat inScaleY,
+					  const GLfloat inSize)
+{
+  FT_ULong length = 0;
+  FT_Byte* table = NULL;
+  GLboolean result = GL_TRUE;
+
   if (!__glcFaceDescPrepareFont(This, inContext, inScaleX, inScaleY))
-    return NULL;
+    return GL_FALSE;
 
-  scale /= This->face->units_per_EM;
+  __glcFaceDescSetKerningSize(This, inSize);
 
-  /* Get the values and transform them according to the resolution */
-  outVec[0] = (GLfloat)This->face->max_advance_width * scale;
-  outVec[1] = (GLfloat)This->face->max_advance_height * scale;
-  outVec[2] = (GLfloat)This->face->bbox.yMax * scale;
-  outVec[3] = (GLfloat)This->face->bbox.yMin * scale;
-  outVec[4] = (GLfloat)This->face->bbox.xMax * scale;
-  outVec[5] = (GLfloat)This->face->bbox.xMin * scale;
+  if (FT_HAS_KERNING(This->face)) {
+    /* The kerning of the faces that are not stored in SFNT files (Type 1 fonts
+     * with AFM files for instance) can not be enumerated : FreeType is then
+     * queried for each pair.
+     */
+    if (!FT_IS_SFNT(This->face)
+	|| FT_Load_Sfnt_Table(This->face, TTAG_kern, 0, NULL, &length))
+      This->kerningFallback = GL_TRUE;
+    else {
+      table = (FT_Byte*)__glcMalloc(length);
+      if (!table) {
+	__glcRaiseError(GLC_RESOURCE_ERROR);
+	result = GL_FALSE;
+      }
+      else if (FT_Load_Sfnt_Table(This->face, TTAG_kern, 0, table, &length))
+	This->kerningFallback = GL_TRUE;
+      else
+	result = __glcFaceDescReadKerningTable(This, table, length);
+    }
+  }
 
 #ifndef GLC_FT_CACHE
   __glcFaceDescClose(This);
 #endif
-  return outVec;
+
+  if (table)
+    __glcFree(table);
+
+  if (result && (This->kerningCount < 0))
+    This->kerningCount = 0;
+
+  return result;
 }
 
 
@@ -797,19 +1253,71 @@ GLfloat* __glcFaceDescGetKerning(__GLCfaceDescriptor* This,
 {
   FT_Vector kerning;
   FT_Error error;
+  GLfloat size = inScaleX;
 
   assert(outVec);
 
-  if (!__glcFaceDescPrepareGlyph(This, inContext, inScaleX, inScaleY,
-				 inGlyphIndex))
-    return NULL;
+  if (!inContext->enableState.glObjects)
+    size *= inContext->renderState.resolution / 72.;
+
+  if (This->kerningCount < 0) {
+    if (!__glcFaceDescLoadKerning(This, inContext, inScaleX, inScaleY, size))
+      return NULL;
+  }
+
+  if (!This->kerningFallback) {
+    GLuint pair = (inPrevGlyphIndex << 16) | inGlyphIndex;
+    GLint lower = 0;
+    GLint upper = This->kerningCount - 1;
 
-  if (!FT_HAS_KERNING(This->face)) {
     outVec[0] = 0.;
     outVec[1] = 0.;
+
+    /* The glyph indices of the 'kern' table are 16 bits wide */
+    if ((inGlyphIndex > 0xffff) || (inPrevGlyphIndex > 0xffff))
+      return outVec;
+
+    while (lower <= upper) {
+      GLint middle = (lower + upper) >> 1;
+
+      if (pair < This->kerningPairs[middle].pair)
+	upper = middle - 1;
+      else if (pair > This->kerningPairs[middle].pair)
+	lower = middle + 1;
+      else {
+	FT_Pos value = 0;
+
+	/* The scale of the face only needs to be queried again when the size
+	 * changes.
+	 */
+	if (size != This->kerningSize) {
+	  if (!__glcFaceDescPrepareFont(This, inContext, inScaleX, inScaleY))
+	    return NULL;
+	  __glcFaceDescSetKerningSize(This, size);
+#ifndef GLC_FT_CACHE
+	  __glcFaceDescClose(This);
+#endif
+	}
+
+	/* Scale and grid-fit the value like FT_Get_Kerning() does in its
+	 * default mode.
+	 */
+	value = FT_MulFix(This->kerningPairs[middle].value, This->kerningScale);
+	if (This->kerningPPEM < 25)
+	  value = FT_MulDiv(value, This->kerningPPEM, 25);
+
+	outVec[0] = (GLfloat)((value + 32) & -64) / 64. / inScaleX;
+	break;
+      }
+    }
+
     return outVec;
   }
 
+  /* FreeType does not need the glyph to be loaded to compute the kerning */
+  if (!__glcFaceDescPrepareFont(This, inContext, inScaleX, inScaleY))
+    return NULL;
+
   error = FT_Get_Kerning(This->face, inPrevGlyphIndex, inGlyphIndex,
 			 FT_KERNING_DEFAULT, &kerning);
 
@@ -931,7 +1439,7 @@ static int __glcConicTo(FT_Vector *inVecControl, FT_Vector *inVecTo,
   data->vector[3] = (GLfloat)inVecControl->y;
   data->vector[4] = (GLfloat)inVecTo->x;
   data->vector[5] = (GLfloat)inVecTo->y;
-  error = __glcdeCasteljauConic(inUserData);
+  error = __glcFlattenConic(inUserData);
   data->vector[0] = (GLfloat) inVecTo->x;
   data->vector[1] = (GLfloat) inVecTo->y;
 
@@ -964,7 +1472,7 @@ static int __glcCubicTo(FT_Vector *inVecControl1, FT_Vector *inVecControl2,
   data->vector[5] = (GLfloat)inVecControl2->y;
   data->vector[6] = (GLfloat)inVecTo->x;
   data->vector[7] = (GLfloat)inVecTo->y;
-  error = __glcdeCasteljauCubic(inUserData);
+  error = __glcFlattenCubic(inUserData);
   data->vector[0] = (GLfloat) inVecTo->x;
   data->vector[1] = (GLfloat) inVecTo->y;
 
@@ -1002,11 +1510,22 @@ GLboolean __glcFaceDescOutlineDecompose(const __GLCfaceDescriptor* This,
 
   if (inContext->enableState.glObjects) {
     /* Distances are computed in object space, so is the tolerance of the
-     * de Casteljau algorithm.
+     * flattening of the curves.
      */
     inData->tolerance *= face->units_per_EM;
   }
 
+  /* Reserve room for the vertices and the contours : the flattening of the
+   * curves adds some vertices, so the number of points of the outline is only a
+   * lower bound.
+   */
+  if (!__glcArrayReserve(inData->vertexArray,
+			 GLC_ARRAY_LENGTH(inData->vertexArray) + outline->n_points)
+      || !__glcArrayReserve(inData->endContour,
+			    GLC_ARRAY_LENGTH(inData->endContour)
+			    + outline->n_contours + 1))
+    return GL_FALSE;
+
   /* Parse the outline of the glyph */
   if (FT_Outline_Decompose(outline, &outlineInterface, inData)) {
     __glcRaiseError(GLC_RESOURCE_ERROR);
@@ -1104,12 +1623,19 @@ GLboolean __glcFaceDescGetBitmapSize(const __GLCfaceDescriptor* This,
       GLfloat ratioX = 0.f;
       GLfloat ratioY = 0.f;
       GLfloat ratio = 0.f;
+      GLint size = GLC_TEXTURE_SIZE;
+
+      /* The distance field needs some room around the glyph in order to store
+       * the distances to the outline outside of the glyph.
+       */
+      if (inContext->renderState.renderStyle == GLC_SDF_QSO)
+	size -= 2 * GLC_SDF_SPREAD;
 
       width = boundingBox.xMax - boundingBox.xMin;
       height = boundingBox.yMax - boundingBox.yMin;
 
-      ratioX = width / (64.f * GLC_TEXTURE_SIZE);
-      ratioY = height / (64.f * GLC_TEXTURE_SIZE);
+      ratioX = width / (64.f * size);
+      ratioY = height / (64.f * size);
 
       ratioX = (ratioX > 1.f) ? ratioX : 1.f;
       ratioY = (ratioY > 1.f) ? ratioY : 1.f;
@@ -1121,14 +1647,18 @@ GLboolean __glcFaceDescGetBitmapSize(const __GLCfaceDescriptor* This,
       outline.flags |= FT_OUTLINE_HIGH_PRECISION;
 
       if (ratio > 1.f) {
+	/* The glyph is scaled down by 'ratio' and centered in its area of the
+	 * atlas (see __glcFaceDescGetBitmapOrigin()) : the quad is centered on
+	 * the glyph and its size is the size of the area scaled up by 'ratio'.
+	 */
 	outPixBoundingBox[0] = boundingBox.xMin
-	  - ((GLint)((GLC_TEXTURE_SIZE << 5) - (width * 0.5f)) * ratio);
+	  + (GLint)((width * 0.5f) - ((GLC_TEXTURE_SIZE << 5) * ratio));
 	outPixBoundingBox[1] = boundingBox.yMin
-	  - ((GLint)((GLC_TEXTURE_SIZE << 5) - (height * 0.5f)) * ratio);
+	  + (GLint)((height * 0.5f) - ((GLC_TEXTURE_SIZE << 5) * ratio));
 	outPixBoundingBox[2] = outPixBoundingBox[0]
-	  + ((GLint)((GLC_TEXTURE_SIZE << 6) * ratio));
+	  + ((GLint)(((GLC_TEXTURE_SIZE - 1) << 6) * ratio));
 	outPixBoundingBox[3] = outPixBoundingBox[1]
-	  + ((GLint)((GLC_TEXTURE_SIZE << 6) * ratio));
+	  + ((GLint)(((GLC_TEXTURE_SIZE - 1) << 6) * ratio));
 
 	matrix.xx = (FT_Fixed)(65536.f / ratio);
 	matrix.yy = matrix.xx;
@@ -1179,31 +1709,27 @@ GLboolean __glcFaceDescGetBitmapSize(const __GLCfaceDescriptor* This,
 
 
 
-/* Render the glyph in a bitmap */
-GLboolean __glcFaceDescGetBitmap(const __GLCfaceDescriptor* This,
-				 const GLint inWidth, const GLint inHeight,
-				 const void* inBuffer,
-				 const __GLCcontext* inContext)
+/* Compute the position of the lower left corner of the bitmap of size
+ * 'inWidth' x 'inHeight' in which the outline 'inOutline' is rendered.
+ */
+static void __glcFaceDescGetBitmapOrigin(FT_Outline* inOutline,
+					 const GLint inWidth,
+					 const GLint inHeight,
+					 FT_Pos* outX, FT_Pos* outY,
+					 const __GLCcontext* inContext)
 {
-  FT_Outline outline;
   FT_BBox boundingBox;
-  FT_Bitmap pixmap;
-  FT_Matrix matrix;
   FT_Pos dx = 0, dy = 0;
-  FT_Face face = This->face;
   FT_Pos width = 0, height = 0;
 
-  assert(face);
-
-  outline = face->glyph->outline;
-  FT_Outline_Get_CBox(&outline, &boundingBox);
+  FT_Outline_Get_CBox(inOutline, &boundingBox);
 
   if ((inContext->renderState.renderStyle == GLC_BITMAP)
       || (inContext->renderState.renderStyle == GLC_PIXMAP_QSO)
       || (!inContext->enableState.glObjects)) {
     dx = GLC_FLOOR_26_6(boundingBox.xMin);
     dy = GLC_FLOOR_26_6(boundingBox.yMin);
-    if (inContext->renderState.renderStyle == GLC_TEXTURE) {
+    if (GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)) {
       width = (GLC_CEIL_26_6(boundingBox.xMax) - dx) >> 6;
       height = (GLC_CEIL_26_6(boundingBox.yMax) - dy) >> 6;
       dx -= (((inWidth - width) >> 1) << 6);
@@ -1218,7 +1744,46 @@ GLboolean __glcFaceDescGetBitmap(const __GLCfaceDescriptor* This,
     dx -= (inWidth << 5) - (width >> 1);
     dy -= (inHeight << 5) - (height >> 1);
   }
-  
+
+  *outX = dx;
+  *outY = dy;
+}
+
+
+
+/* Prepare the outline for the next mipmap level : divide the character size
+ * by 2.
+ */
+static void __glcFaceDescHalveOutline(FT_Outline* inOutline)
+{
+  FT_Matrix matrix;
+
+  matrix.xx = 32768; /* 0.5 in FT_Fixed type */
+  matrix.xy = 0;
+  matrix.yx = 0;
+  matrix.yy = 32768;
+  FT_Outline_Transform(inOutline, &matrix);
+}
+
+
+
+/* Render the glyph in a bitmap */
+GLboolean __glcFaceDescGetBitmap(const __GLCfaceDescriptor* This,
+				 const GLint inWidth, const GLint inHeight,
+				 const void* inBuffer,
+				 const __GLCcontext* inContext)
+{
+  FT_Outline outline;
+  FT_Bitmap pixmap;
+  FT_Pos dx = 0, dy = 0;
+  FT_Face face = This->face;
+
+  assert(face);
+
+  outline = face->glyph->outline;
+  __glcFaceDescGetBitmapOrigin(&outline, inWidth, inHeight, &dx, &dy,
+			       inContext);
+
   pixmap.width = inWidth;
   pixmap.rows = inHeight;
   pixmap.buffer = (unsigned char*)inBuffer;
@@ -1261,11 +1826,66 @@ GLboolean __glcFaceDescGetBitmap(const __GLCfaceDescriptor* This,
     FT_Outline_Translate(&outline, dx, dy);
 
     /* b. Divide the character size by 2. */
-    matrix.xx = 32768; /* 0.5 in FT_Fixed type */
-    matrix.xy = 0;
-    matrix.yx = 0;
-    matrix.yy = 32768;
-    FT_Outline_Transform(&outline, &matrix);
+    __glcFaceDescHalveOutline(&outline);
+  }
+
+  return GL_TRUE;
+}
+
+
+
+/* Decompose the outline of the glyph in the pixel space of the bitmap that
+ * __glcFaceDescGetBitmap() would render : the contours are stored in
+ * 'inData' with one unit per pixel, the origin being located at the lower left
+ * corner of the bitmap. As for __glcFaceDescGetBitmap(), the outline is then
+ * prepared for the next mipmap level.
+ */
+GLboolean __glcFaceDescGetBitmapContours(const __GLCfaceDescriptor* This,
+					 const GLint inWidth,
+					 const GLint inHeight,
+					 __GLCrendererData* inData,
+					 const __GLCcontext* inContext)
+{
+  FT_Outline outline;
+  FT_Outline_Funcs outlineInterface;
+  FT_Pos dx = 0, dy = 0;
+  FT_Face face = This->face;
+  FT_Error error = 0;
+
+  assert(face);
+
+  outline = face->glyph->outline;
+  __glcFaceDescGetBitmapOrigin(&outline, inWidth, inHeight, &dx, &dy,
+			       inContext);
+
+  outlineInterface.shift = 0;
+  outlineInterface.delta = 0;
+  outlineInterface.move_to = __glcMoveTo;
+  outlineInterface.line_to = __glcLineTo;
+  outlineInterface.conic_to = __glcConicTo;
+  outlineInterface.cubic_to = __glcCubicTo;
+
+  if (!__glcArrayReserve(inData->vertexArray,
+			 GLC_ARRAY_LENGTH(inData->vertexArray) + outline.n_points)
+      || !__glcArrayReserve(inData->endContour,
+			    GLC_ARRAY_LENGTH(inData->endContour)
+			    + outline.n_contours + 1))
+    return GL_FALSE;
+
+  /* Translate the outline to match (0,0) with the lower left corner of the
+   * bitmap then parse it.
+   */
+  FT_Outline_Translate(&outline, -dx, -dy);
+  error = FT_Outline_Decompose(&outline, &outlineInterface, inData);
+  FT_Outline_Translate(&outline, dx, dy);
+  __glcFaceDescHalveOutline(&outline);
+
+  if (error || !__glcArrayAppend(inData->endContour,
+				 &GLC_ARRAY_LENGTH(inData->vertexArray))) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    GLC_ARRAY_LENGTH(inData->vertexArray) = 0;
+    GLC_ARRAY_LENGTH(inData->endContour) = 0;
+    return GL_FALSE;
   }
 
   return GL_TRUE;
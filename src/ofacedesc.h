@@ -30,6 +30,14 @@
 
 typedef struct __GLCrendererDataRec __GLCrendererData;
 typedef struct __GLCfaceDescriptorRec __GLCfaceDescriptor;
+typedef struct __GLCkerningPairRec __GLCkerningPair;
+
+#define GLC_ADVANCE_PAGE_SIZE	256
+
+struct __GLCkerningPairRec {
+  GLuint pair;			/* Left glyph index << 16 | right glyph index */
+  GLint value;			/* Kerning in font units */
+};
 
 struct __GLCfaceDescriptorRec {
   FT_ListNodeRec node;
@@ -39,6 +47,18 @@ struct __GLCfaceDescriptorRec {
   int faceRefCount;
 #endif
   FT_ListRec glyphList;
+  __GLCkerningPair* kerningPairs; /* Pairs of the 'kern' table of the face */
+  GLint kerningCount;		/* Number of pairs, -1 if not read yet */
+  GLboolean kerningFallback;	/* Use FT_Get_Kerning() instead of the pairs */
+  GLfloat kerningSize;		/* Size at which the kerning is scaled */
+  FT_Fixed kerningScale;	/* Scale of the face for 'kerningSize' */
+  FT_UShort kerningPPEM;	/* Pixels per EM of the face for 'kerningSize' */
+  FT_UShort unitsPerEM;		/* Font units per EM, 0 if not read yet */
+  GLint** advancePages;		/* Advances in font units by pages of glyphs */
+  GLint advancePageCount;	/* Number of pages of 'advancePages' */
+  GLint maxMetric[6];		/* Max advances and bounding box in font units */
+  GLboolean maxMetricCached;	/* Has 'maxMetric' been read ? */
+  __GLCrenderRecords records;	/* Render records of the glyphs of the face */
 };
 
 
@@ -71,6 +91,15 @@ GLfloat* __glcFaceDescGetAdvance(__GLCfaceDescriptor* This,
 				 const GLCulong inGlyphIndex, GLfloat* outVec,
 				 const GLfloat inScaleX, const GLfloat inScaleY,
 				 const __GLCcontext* inContext);
+GLboolean __glcFaceDescGetUnscaledMetrics(__GLCfaceDescriptor* This,
+					  const GLCulong inGlyphIndex,
+					  GLint* outAdvance,
+					  GLint* outBoundingBox,
+					  const __GLCcontext* inContext);
+GLboolean __glcFaceDescGetUnscaledAdvance(__GLCfaceDescriptor* This,
+					  const GLCulong inGlyphIndex,
+					  GLint* outAdvance,
+					  const __GLCcontext* inContext);
 const GLCchar8* __glcFaceDescGetFontFormat(const __GLCfaceDescriptor* This,
 					   const __GLCcontext* inContext,
 					   const GLCenum inAttrib);
@@ -100,6 +129,11 @@ GLboolean __glcFaceDescGetBitmap(const __GLCfaceDescriptor* This,
 				 const GLint inWidth, const GLint inHeight,
 				 const void* inBuffer,
 				 const __GLCcontext* inContext);
+GLboolean __glcFaceDescGetBitmapContours(const __GLCfaceDescriptor* This,
+					 const GLint inWidth,
+					 const GLint inHeight,
+					 __GLCrendererData* inData,
+					 const __GLCcontext* inContext);
 GLboolean __glcFaceDescOutlineEmpty(__GLCfaceDescriptor* This);
 __GLCcharMap* __glcFaceDescGetCharMap(__GLCfaceDescriptor* This,
 				      __GLCcontext* inContext);
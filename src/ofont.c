@@ -74,8 +74,6 @@ __GLCfont* __glcFontCreate(GLint inID, __GLCmaster* inMaster,
   }
 
   This->id = inID;
-  This->maxMetricCached = GL_FALSE;
-  memset(This->maxMetric, 0, 6 * sizeof(GLfloat));
 
   return This;
 }
@@ -105,7 +103,11 @@ __GLCglyph* __glcFontGetGlyph(const __GLCfont *This, const GLint inCode,
   /* Try to get the glyph from the character map */
   __GLCglyph* glyph = __glcCharMapGetGlyph(This->charMap, inCode);
 
-  if (!glyph) {
+  if (glyph)
+    GLC_STAT_INC(inContext, GLC_CHARMAP_HIT_COUNT_QSO);
+  else {
+    GLC_STAT_INC(inContext, GLC_CHARMAP_MISS_COUNT_QSO);
+
     /* If it fails, we must extract the glyph from the face */
     glyph = __glcFaceDescGetGlyph(This->faceDesc, inCode, inContext);
     if (!glyph)
@@ -120,6 +122,49 @@ __GLCglyph* __glcFontGetGlyph(const __GLCfont *This, const GLint inCode,
 
 
 
+/* Load the advance and the bounding box of a glyph in font units unless they
+ * are already cached.
+ */
+static GLboolean __glcFontLoadUnscaledMetrics(const __GLCfont* This,
+					      __GLCglyph* inGlyph,
+					      const __GLCcontext* inContext)
+{
+  if (inGlyph->unscaledCached)
+    return GL_TRUE;
+
+  if (!__glcFaceDescGetUnscaledMetrics(This->faceDesc, inGlyph->index,
+				       inGlyph->unscaledAdvance,
+				       inGlyph->unscaledBoundingBox, inContext))
+    return GL_FALSE;
+
+  inGlyph->unscaledCached = GL_TRUE;
+  return GL_TRUE;
+}
+
+
+
+/* The hinted metrics of a glyph are cached for a single pixel size. If the
+ * size requested by inScaleX and inScaleY differs from the cached one then the
+ * hinted metrics are discarded.
+ */
+static void __glcFontCheckHintedSize(__GLCglyph* inGlyph,
+				     const __GLCcontext* inContext,
+				     const GLfloat inScaleX,
+				     const GLfloat inScaleY)
+{
+  GLfloat sizeX = inScaleX * inContext->renderState.resolution / 72.;
+  GLfloat sizeY = inScaleY * inContext->renderState.resolution / 72.;
+
+  if ((sizeX != inGlyph->hintedSize[0]) || (sizeY != inGlyph->hintedSize[1])) {
+    inGlyph->hintedSize[0] = sizeX;
+    inGlyph->hintedSize[1] = sizeY;
+    inGlyph->hintedAdvanceCached = GL_FALSE;
+    inGlyph->hintedBoundingBoxCached = GL_FALSE;
+  }
+}
+
+
+
 /* Get the bounding box of a glyph according to the size given by inScaleX and
  * inScaleY. The result is returned in outVec. 'inCode' contains the character
  * code for which the bounding box is requested.
@@ -139,15 +184,46 @@ GLfloat* __glcFontGetBoundingBox(const __GLCfont *This, const GLint inCode,
   /* If the bounding box of the glyph is cached then copy it to outVec and
    * return.
    */
-  if (glyph->boundingBoxCached && inContext->enableState.glObjects) {
-    memcpy(outVec, glyph->boundingBox, 4 * sizeof(GLfloat));
-    return outVec;
+  if (inContext->enableState.glObjects) {
+    if (glyph->boundingBoxCached) {
+      memcpy(outVec, glyph->boundingBox, 4 * sizeof(GLfloat));
+      return outVec;
+    }
+  }
+  else if (inContext->enableState.hinting) {
+    __glcFontCheckHintedSize(glyph, inContext, inScaleX, inScaleY);
+
+    if (glyph->hintedBoundingBoxCached) {
+      outVec[0] = glyph->hintedBoundingBox[0] / inScaleX;
+      outVec[1] = glyph->hintedBoundingBox[1] / inScaleY;
+      outVec[2] = glyph->hintedBoundingBox[2] / inScaleX;
+      outVec[3] = glyph->hintedBoundingBox[3] / inScaleY;
+      return outVec;
+    }
   }
 
-  /* Otherwise, we must extract the bounding box from the face file */
-  if (!__glcFaceDescGetBoundingBox(This->faceDesc, glyph->index, outVec,
-				   inScaleX, inScaleY, inContext))
-    return NULL;
+  if (!inContext->enableState.glObjects && !inContext->enableState.hinting) {
+    /* Unhinted metrics scale linearly with the size so they are computed from
+     * the bounding box in font units.
+     */
+    GLfloat scale = 0.f;
+
+    if (!__glcFontLoadUnscaledMetrics(This, glyph, inContext))
+      return NULL;
+
+    scale = inContext->renderState.resolution / 72.
+      / This->faceDesc->unitsPerEM;
+    outVec[0] = glyph->unscaledBoundingBox[0] * scale;
+    outVec[1] = glyph->unscaledBoundingBox[1] * scale;
+    outVec[2] = glyph->unscaledBoundingBox[2] * scale;
+    outVec[3] = glyph->unscaledBoundingBox[3] * scale;
+  }
+  else {
+    /* Otherwise, we must extract the bounding box from the face file */
+    if (!__glcFaceDescGetBoundingBox(This->faceDesc, glyph->index, outVec,
+				     inScaleX, inScaleY, inContext))
+      return NULL;
+  }
 
   /* Special case for glyphes which have no bounding box (i.e. spaces) */
   if ((fabs(outVec[0] - outVec[2]) < GLC_EPSILON)
@@ -169,6 +245,14 @@ GLfloat* __glcFontGetBoundingBox(const __GLCfont *This, const GLint inCode,
     memcpy(glyph->boundingBox, outVec, 4 * sizeof(GLfloat));
     glyph->boundingBoxCached = GL_TRUE;
   }
+  else if (inContext->enableState.hinting) {
+    /* The hinted bounding box is stored in pixels */
+    glyph->hintedBoundingBox[0] = outVec[0] * inScaleX;
+    glyph->hintedBoundingBox[1] = outVec[1] * inScaleY;
+    glyph->hintedBoundingBox[2] = outVec[2] * inScaleX;
+    glyph->hintedBoundingBox[3] = outVec[3] * inScaleY;
+    glyph->hintedBoundingBoxCached = GL_TRUE;
+  }
 
   return outVec;
 }
@@ -194,8 +278,40 @@ GLfloat* __glcFontGetAdvance(const __GLCfont* This, const GLint inCode,
   /* If the advance of the glyph is cached then copy it to outVec and
    * return.
    */
-  if (glyph->advanceCached && inContext->enableState.glObjects) {
-    memcpy(outVec, glyph->advance, 2 * sizeof(GLfloat));
+  if (inContext->enableState.glObjects) {
+    if (glyph->advanceCached) {
+      memcpy(outVec, glyph->records->advance[glyph->record],
+	     2 * sizeof(GLfloat));
+      return outVec;
+    }
+  }
+  else if (inContext->enableState.hinting) {
+    __glcFontCheckHintedSize(glyph, inContext, inScaleX, inScaleY);
+
+    if (glyph->hintedAdvanceCached) {
+      outVec[0] = glyph->hintedAdvance[0] / inScaleX;
+      outVec[1] = glyph->hintedAdvance[1] / inScaleY;
+      return outVec;
+    }
+  }
+  else {
+    /* Unhinted metrics scale linearly with the size so they are computed from
+     * the advance in font units. It is read from the advance table of the face
+     * unless the glyph has already been loaded.
+     */
+    GLfloat scale = 0.f;
+    GLint advance[2] = {0, 0};
+
+    if (glyph->unscaledCached)
+      memcpy(advance, glyph->unscaledAdvance, 2 * sizeof(GLint));
+    else if (!__glcFaceDescGetUnscaledAdvance(This->faceDesc, glyph->index,
+					      advance, inContext))
+      return NULL;
+
+    scale = inContext->renderState.resolution / 72.
+      / This->faceDesc->unitsPerEM;
+    outVec[0] = advance[0] * scale;
+    outVec[1] = advance[1] * scale;
     return outVec;
   }
 
@@ -206,9 +322,16 @@ GLfloat* __glcFontGetAdvance(const __GLCfont* This, const GLint inCode,
 
   /* Copy the result to outVec and return */
   if (inContext->enableState.glObjects) {
-    memcpy(glyph->advance, outVec, 2 * sizeof(GLfloat));
+    memcpy(glyph->records->advance[glyph->record], outVec,
+	   2 * sizeof(GLfloat));
     glyph->advanceCached = GL_TRUE;
   }
+  else {
+    /* The hinted advance is stored in pixels */
+    glyph->hintedAdvance[0] = outVec[0] * inScaleX;
+    glyph->hintedAdvance[1] = outVec[1] * inScaleY;
+    glyph->hintedAdvanceCached = GL_TRUE;
+  }
 
   return outVec;
 }
@@ -224,22 +347,11 @@ GLfloat* __glcFontGetMaxMetric(__GLCfont* This, GLfloat* outVec,
 {
   assert(outVec);
 
-  if (This->maxMetricCached && inContext->enableState.glObjects) {
-    memcpy(outVec, This->maxMetric, 6 * sizeof(GLfloat));
-    return outVec;
-  }
-
-  if (!__glcFaceDescGetMaxMetric(This->faceDesc, outVec, inContext, inScaleX,
-				 inScaleY))
-    return NULL;
-
-  /* Copy the result to outVec and return */
-  if (inContext->enableState.glObjects) {
-    memcpy(This->maxMetric, outVec, 6 * sizeof(GLfloat));
-    This->maxMetricCached = GL_TRUE;
-  }
-
-  return outVec;
+  /* The face descriptor keeps the values in font units : they are valid
+   * whatever the state of GLC_GL_OBJECTS and the resolution are.
+   */
+  return __glcFaceDescGetMaxMetric(This->faceDesc, outVec, inContext,
+				   inScaleX, inScaleY);
 }
 
 
@@ -325,8 +437,7 @@ GLboolean __glcFontFace(__GLCfont* This, const GLCchar8* inFace,
 
   __glcFaceDescDestroy(This->faceDesc, inContext);
   This->faceDesc = faceDesc;
-  This->maxMetricCached = GL_FALSE;
-  memset(This->maxMetric, 0, 6 * sizeof(GLfloat));
+  __glcStringCacheInvalidate(inContext->stringCache);
 
   return GL_TRUE;
 }
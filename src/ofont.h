@@ -37,8 +37,6 @@ struct __GLCfontRec {
   __GLCfaceDescriptor* faceDesc;
   GLint parentMasterID;
   __GLCcharMap* charMap;
-  GLfloat maxMetric[6];
-  GLboolean maxMetricCached;
 };
 
 __GLCfont*  __glcFontCreate(GLint id, __GLCmaster* inMaster,
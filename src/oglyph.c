@@ -34,17 +34,16 @@
 /* Constructor of the object : it allocates memory and initializes the member
  * of the new object.
  * The user must give the index of the glyph in the font file and its Unicode
- * codepoint.
+ * codepoint. The memory is taken from the glyph pool of the context.
  */
-__GLCglyph* __glcGlyphCreate(const GLCulong inIndex, const GLCulong inCode)
+__GLCglyph* __glcGlyphCreate(const GLCulong inIndex, const GLCulong inCode,
+			     const __GLCcontext* inContext)
 {
   __GLCglyph* This = NULL;
 
-  This = (__GLCglyph*)__glcMalloc(sizeof(__GLCglyph));
-  if (!This) {
-    __glcRaiseError(GLC_RESOURCE_ERROR);
+  This = (__GLCglyph*)__glcPoolAlloc(inContext->glyphPool);
+  if (!This)
     return NULL;
-  }
   memset(This, 0, sizeof(__GLCglyph));
 
   This->node.data = This;
@@ -53,6 +52,9 @@ __GLCglyph* __glcGlyphCreate(const GLCulong inIndex, const GLCulong inCode)
   This->isSpacingChar = GL_FALSE;
   This->advanceCached = GL_FALSE;
   This->boundingBoxCached = GL_FALSE;
+  This->unscaledCached = GL_FALSE;
+  This->hintedAdvanceCached = GL_FALSE;
+  This->hintedBoundingBoxCached = GL_FALSE;
 
   return This;
 }
@@ -63,7 +65,7 @@ __GLCglyph* __glcGlyphCreate(const GLCulong inIndex, const GLCulong inCode)
 void __glcGlyphDestroy(__GLCglyph* This, __GLCcontext* inContext)
 {
   __glcGlyphDestroyGLObjects(This, inContext);
-  __glcFree(This);
+  __glcPoolFree(inContext->glyphPool, This);
 }
 
 
@@ -75,6 +77,7 @@ void __glcGlyphDestroyTexture(__GLCglyph* This, const __GLCcontext* inContext)
     glDeleteLists(This->glObject[1], 1);
   This->glObject[1] = 0;
   This->textureObject = NULL;
+  This->records->atlasVertex[This->record] = -1;
 }
 
 
@@ -30,28 +30,62 @@
 typedef struct __GLCglyphRec __GLCglyph;
 typedef struct __GLCatlasElementRec __GLCatlasElement;
 typedef struct __GLCgeomBatchRec __GLCgeomBatch;
+typedef struct __GLCrenderRecordsRec __GLCrenderRecords;
+
+/* Render records of the glyphs of a face. They are stored as a structure of
+ * arrays indexed by the member 'record' of the glyphs : the render loop reads
+ * the records of the characters in order and only loads the cache lines of
+ * the data that it actually uses, instead of the whole glyph objects.
+ */
+struct __GLCrenderRecordsRec {
+  GLint count;			/* Number of records */
+  GLint size;			/* Number of records that have been allocated */
+  GLfloat (*advance)[2];	/* Advances when GLC_GL_OBJECTS is enabled */
+  GLfloat (*atlasRect)[8];	/* Texture coordinates s0, t0, s1, t1 then
+				 * vertex coordinates x0, y0, x1, y1 of the
+				 * quad of the glyph in the texture atlas */
+  GLint* atlasVertex;		/* First vertex of the quad in the VBO of the
+				 * atlas, -1 if the glyph is not in the atlas */
+};
 
 struct __GLCglyphRec {
-  FT_ListNodeRec node;
+  /* Hot data : they are read by the render loop for every character so they
+   * are grouped at the beginning of the object in order to share a cache line.
+   */
+  GLuint glObject[4];
+  __GLCatlasElement* textureObject;
+  __GLCrenderRecords* records;	/* Render records of the face of the glyph */
+  GLint record;			/* Index of the glyph in 'records' */
+  GLboolean isSpacingChar;
+  GLboolean advanceCached;
+  GLboolean boundingBoxCached;
+  GLCulong codepoint;
 
+  /* Cold data : they are only needed when the glyph is built or measured */
+  FT_ListNodeRec node;
   GLCulong index;
-  GLCulong codepoint;
-  /* GL objects management */
-  __GLCatlasElement* textureObject;
-  GLuint glObject[4];
   GLint nContour;
   GLint* contours;
   GLint nGeomBatch;
   __GLCgeomBatch* geomBatches;
-  /* Measurement infos */
   GLfloat boundingBox[4];
-  GLfloat advance[2];
-  GLboolean advanceCached;
-  GLboolean boundingBoxCached;
-  GLboolean isSpacingChar;
+
+  /* Metrics used when GLC_GL_OBJECTS is disabled : the unhinted ones are
+   * stored in font units and scaled on demand, the hinted ones are only valid
+   * for the pixel size 'hintedSize'.
+   */
+  GLint unscaledAdvance[2];
+  GLint unscaledBoundingBox[4];
+  GLboolean unscaledCached;
+  GLboolean hintedAdvanceCached;
+  GLboolean hintedBoundingBoxCached;
+  GLfloat hintedSize[2];
+  GLfloat hintedAdvance[2];
+  GLfloat hintedBoundingBox[4];
 };
 
-__GLCglyph* __glcGlyphCreate(const GLCulong inIndex, const GLCulong inCode);
+__GLCglyph* __glcGlyphCreate(const GLCulong inIndex, const GLCulong inCode,
+			     const __GLCcontext* inContext);
 void __glcGlyphDestroy(__GLCglyph* This, __GLCcontext* inContext);
 void __glcGlyphDestroyTexture(__GLCglyph* This, const __GLCcontext* inContext);
 void __glcGlyphDestroyGLObjects(__GLCglyph* This, __GLCcontext* inContext);
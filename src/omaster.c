@@ -506,6 +506,7 @@ __GLCmaster* __glcMasterMatchCode(const __GLCcontext* inContext,
     return NULL;
   }
   FcDefaultSubstitute(pattern);
+  GLC_STAT_INC(inContext, GLC_FONT_MATCH_COUNT_QSO);
   fontSet = FcFontSort(inContext->config, pattern, FcFalse, NULL, &result);
   FcPatternDestroy(pattern);
   if ((!fontSet) || (result == FcResultTypeMismatch)) {
@@ -545,6 +546,7 @@ __GLCmaster* __glcMasterMatchCode(const __GLCcontext* inContext,
     FcFontSetDestroy(fontSet);
     return NULL;
   }
+  GLC_STAT_INC(inContext, GLC_FONT_MATCH_COUNT_QSO);
   fontSet2 = FcFontList(inContext->config, fontSet->fonts[f], objectSet);
   FcObjectSetDestroy(objectSet);
   if (!fontSet2) {
@@ -0,0 +1,192 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * defines the object __GLCpool which is a slab allocator that serves the small
+ * objects of fixed size that a GLC context creates and destroys over and over
+ * again : the glyphs, the elements of the texture atlas and the nodes of the
+ * font lists.
+ */
+
+/* The objects are carved in slabs of GLC_POOL_SLAB_COUNT objects so that they
+ * are stored contiguously in memory and cost one call to the heap allocator
+ * every GLC_POOL_SLAB_COUNT objects. A released object is pushed on a free
+ * list and is the next one to be served by the pool. The slabs are only given
+ * back to the heap when the pool is destroyed, which releases all the objects
+ * at once.
+ * The pool also embeds a FreeType memory manager so that the list nodes that
+ * it serves can be released by FT_List_Finalize().
+ */
+
+#include "internal.h"
+
+#define GLC_POOL_SLAB_COUNT 64
+#define GLC_POOL_ALIGN 8
+#define GLC_POOL_ROUND(size) (((size) + GLC_POOL_ALIGN - 1) \
+			      & ~((size_t)GLC_POOL_ALIGN - 1))
+#define GLC_POOL_HEADER_SIZE GLC_POOL_ROUND(sizeof(__GLCpoolSlab))
+#define GLC_POOL_SLAB_DATA(slab) ((char*)(slab) + GLC_POOL_HEADER_SIZE)
+
+
+
+/* Memory manager functions : the pool only serves objects of a fixed size and
+ * can not reallocate them.
+ */
+#ifndef NDEBUG
+static void* __glcPoolAllocFunc(FT_Memory inMemory, long inSize)
+#else
+static void* __glcPoolAllocFunc(FT_Memory inMemory, long GLC_UNUSED_ARG(inSize))
+#endif
+{
+  __GLCpool* pool = (__GLCpool*)inMemory->user;
+
+  assert((size_t)inSize <= pool->elementSize);
+  return __glcPoolAlloc(pool);
+}
+
+
+
+static void __glcPoolFreeFunc(FT_Memory inMemory, void *inBlock)
+{
+  __glcPoolFree((__GLCpool*)inMemory->user, inBlock);
+}
+
+
+
+/* Constructor of the object : no memory is allocated for the objects until
+ * the first of them is requested. The size of the objects must be given by
+ * the user.
+ */
+__GLCpool* __glcPoolCreate(const size_t inElementSize)
+{
+  __GLCpool* This = NULL;
+
+  This = (__GLCpool*)__glcMalloc(sizeof(__GLCpool));
+  if (!This) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    return NULL;
+  }
+  memset(This, 0, sizeof(__GLCpool));
+
+  /* The free list is threaded through the released objects */
+  This->elementSize = GLC_POOL_ROUND(inElementSize < sizeof(void*) ?
+				     sizeof(void*) : inElementSize);
+
+  This->memory.user = This;
+  This->memory.alloc = __glcPoolAllocFunc;
+  This->memory.free = __glcPoolFreeFunc;
+  This->memory.realloc = NULL;
+
+  return This;
+}
+
+
+
+/* Destructor of the object : all the objects served by the pool are released
+ * at once.
+ */
+void __glcPoolDestroy(__GLCpool* This)
+{
+  __GLCpoolSlab* slab = This->slabList;
+
+  while (slab) {
+    __GLCpoolSlab* next = slab->next;
+
+    __glcFree(slab);
+    slab = next;
+  }
+
+  __glcFree(This);
+}
+
+
+
+/* Allocate an object. The object that has been released last is served first,
+ * otherwise the object is carved in the current slab. A new slab is allocated
+ * in the heap if all the slabs are full. The function returns NULL if it fails
+ * and raises an error accordingly.
+ */
+void* __glcPoolAlloc(__GLCpool* This)
+{
+  void* element = This->freeList;
+
+  if (element) {
+    This->freeList = *(void**)element;
+    This->allocCount++;
+    return element;
+  }
+
+  if (!This->slab || (This->used == GLC_POOL_SLAB_COUNT)) {
+    __GLCpoolSlab* slab = This->slab ? This->slab->next : This->slabList;
+
+    /* The slabs that have been emptied by __glcPoolReset() are re-used before
+     * a new one is requested to the heap.
+     */
+    if (!slab) {
+      slab = (__GLCpoolSlab*)__glcMalloc(GLC_POOL_HEADER_SIZE
+					 + GLC_POOL_SLAB_COUNT
+					 * This->elementSize);
+      if (!slab) {
+	__glcRaiseError(GLC_RESOURCE_ERROR);
+	return NULL;
+      }
+
+      slab->next = NULL;
+      if (This->slab)
+	This->slab->next = slab;
+      else
+	This->slabList = slab;
+      This->heapCount++;
+    }
+
+    This->slab = slab;
+    This->used = 0;
+  }
+
+  element = GLC_POOL_SLAB_DATA(This->slab) + This->used * This->elementSize;
+  This->used++;
+  This->allocCount++;
+
+  return element;
+}
+
+
+
+/* Release an object : it is pushed on the free list of the pool */
+void __glcPoolFree(__GLCpool* This, void* inElement)
+{
+  if (!inElement)
+    return;
+
+  *(void**)inElement = This->freeList;
+  This->freeList = inElement;
+}
+
+
+
+/* Release all the objects of the pool at once. The slabs are kept in order
+ * to serve the next objects.
+ */
+void __glcPoolReset(__GLCpool* This)
+{
+  This->slab = NULL;
+  This->used = 0;
+  This->freeList = NULL;
+}
@@ -0,0 +1,52 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * header of the object __GLCpool which is a slab allocator that serves the
+ * small objects of fixed size (glyphs, list nodes, ...) of a GLC context.
+ */
+
+#ifndef __glc_opool_h
+#define __glc_opool_h
+
+typedef struct __GLCpoolRec __GLCpool;
+typedef struct __GLCpoolSlabRec __GLCpoolSlab;
+
+struct __GLCpoolSlabRec {
+  __GLCpoolSlab* next;		/* Slab that has been allocated after this one */
+};
+
+struct __GLCpoolRec {
+  struct FT_MemoryRec_ memory;	/* Memory manager for FT_List_Finalize() */
+  size_t elementSize;		/* Size of the objects served by the pool */
+  __GLCpoolSlab* slabList;	/* Slabs allocated by the pool */
+  __GLCpoolSlab* slab;		/* Slab where the objects are carved */
+  GLuint used;			/* Number of objects carved in 'slab' */
+  void* freeList;		/* Objects that have been released */
+  GLuint allocCount;		/* Number of objects served by the pool */
+  GLuint heapCount;		/* Number of slabs allocated in the heap */
+};
+
+__GLCpool* __glcPoolCreate(const size_t inElementSize);
+void __glcPoolDestroy(__GLCpool* This);
+void* __glcPoolAlloc(__GLCpool* This);
+void __glcPoolFree(__GLCpool* This, void* inElement);
+void __glcPoolReset(__GLCpool* This);
+#endif
@@ -0,0 +1,242 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * defines the object __GLCstringCache which keeps the strings that have been
+ * recently rendered or measured so that the applications which render the
+ * same strings at each frame do not pay the cost of their conversion to UCS4,
+ * of the bidirectional algorithm and of the look up of their glyphs each time.
+ */
+
+/* The cache is enabled by GLC_STRING_CACHE_QSO. It is a LRU list of at most
+ * GLC_STRING_CACHE_SIZE entries which are identified by the bytes of the input
+ * string and the string type. Each entry stores the string converted in visual
+ * order and, once the string has been rendered with GL objects, the characters
+ * (font, glyph and advance) that the rendering loop has resolved. Those ones
+ * are only valid for the rendering style and the kerning mode with which they
+ * have been resolved and as long as the fonts of the context are not modified:
+ * the cache maintains a generation counter which is incremented each time the
+ * current fonts, their faces, their maps or the resolution are changed.
+ */
+
+#include "internal.h"
+
+#define GLC_STRING_CACHE_SIZE 64
+
+
+
+/* Compute the hash value of a string (FNV-1a) */
+static GLCchar32 __glcStringCacheHash(const GLCchar8* inString,
+				      const GLint inSize,
+				      const GLint inStringType)
+{
+  GLCchar32 hash = 2166136261u ^ (GLCchar32)inStringType;
+  GLint i = 0;
+
+  for (i = 0; i < inSize; i++) {
+    hash ^= inString[i];
+    hash *= 16777619u;
+  }
+
+  return hash;
+}
+
+
+
+/* Destroy an entry of the cache */
+static void __glcStringEntryDestroy(__GLCstringEntry* This)
+{
+  if (This->chars)
+    __glcFree(This->chars);
+  __glcFree(This);
+}
+
+
+
+/* Constructor of the object : the cache is initially empty */
+__GLCstringCache* __glcStringCacheCreate(void)
+{
+  __GLCstringCache* This = NULL;
+
+  This = (__GLCstringCache*)__glcMalloc(sizeof(__GLCstringCache));
+  if (!This) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    return NULL;
+  }
+  memset(This, 0, sizeof(__GLCstringCache));
+
+  return This;
+}
+
+
+
+/* Destructor of the object */
+void __glcStringCacheDestroy(__GLCstringCache* This)
+{
+  FT_ListNode node = This->entryList.head;
+
+  /* Don't use FT_List_Finalize here, since the nodes are destroyed with their
+   * entry.
+   */
+  while (node) {
+    FT_ListNode next = node->next;
+
+    __glcStringEntryDestroy((__GLCstringEntry*)node->data);
+    node = next;
+  }
+
+  __glcFree(This);
+}
+
+
+
+/* Look for the string 'inString' of 'inSize' bytes in the cache. If it is
+ * found, the entry is moved at the head of the LRU list and returned.
+ * Otherwise the function returns NULL.
+ */
+__GLCstringEntry* __glcStringCacheLookup(__GLCstringCache* This,
+					 const GLCchar8* inString,
+					 const GLint inSize,
+					 const GLint inStringType)
+{
+  GLCchar32 hash = __glcStringCacheHash(inString, inSize, inStringType);
+  FT_ListNode node = NULL;
+
+  for (node = This->entryList.head; node; node = node->next) {
+    __GLCstringEntry* entry = (__GLCstringEntry*)node->data;
+
+    if ((entry->hash == hash) && (entry->size == inSize)
+	&& (entry->stringType == inStringType)
+	&& !memcmp(entry->string, inString, inSize)) {
+      FT_List_Up(&This->entryList, node);
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+
+
+/* Store the string 'inString' and its conversion in visual order in the
+ * cache. If the cache is full, the least recently used entry is destroyed.
+ * The function returns the new entry or NULL if it fails. No error is raised
+ * in that case since the string can still be processed without the cache.
+ */
+__GLCstringEntry* __glcStringCacheInsert(__GLCstringCache* This,
+					 const GLCchar8* inString,
+					 const GLint inSize,
+					 const GLint inStringType,
+					 const GLCchar32* inVisualString,
+					 const GLint inLength,
+					 const GLboolean inIsRightToLeft)
+{
+  __GLCstringEntry* entry = NULL;
+
+  if (This->entryCount == GLC_STRING_CACHE_SIZE) {
+    FT_ListNode node = This->entryList.tail;
+
+    FT_List_Remove(&This->entryList, node);
+    __glcStringEntryDestroy((__GLCstringEntry*)node->data);
+    This->entryCount--;
+  }
+
+  /* The entry, the visual string and the copy of the input string are stored
+   * in the same block of memory.
+   */
+  entry = (__GLCstringEntry*)__glcMalloc(sizeof(__GLCstringEntry)
+					 + (inLength + 1) * sizeof(GLCchar32)
+					 + inSize);
+  if (!entry)
+    return NULL;
+
+  entry->node.data = entry;
+  entry->hash = __glcStringCacheHash(inString, inSize, inStringType);
+  entry->stringType = inStringType;
+  entry->size = inSize;
+  entry->visualString = (GLCchar32*)(entry + 1);
+  entry->string = (GLCchar8*)(entry->visualString + inLength + 1);
+  entry->length = inLength;
+  entry->isRightToLeft = inIsRightToLeft;
+  entry->chars = NULL;
+  entry->charCount = 0;
+  entry->generation = 0;
+  entry->renderStyle = 0;
+  entry->kerning = GL_FALSE;
+
+  memcpy(entry->visualString, inVisualString, inLength * sizeof(GLCchar32));
+  entry->visualString[inLength] = 0;
+  memcpy(entry->string, inString, inSize);
+
+  FT_List_Insert(&This->entryList, &entry->node);
+  This->entryCount++;
+
+  return entry;
+}
+
+
+
+/* Return the characters that the rendering loop has resolved for the string
+ * of 'inEntry', or NULL if they have not been resolved yet or if they are no
+ * longer valid.
+ */
+const __GLCcharacter*
+__glcStringCacheGetCharacters(const __GLCstringCache* This,
+			      const __GLCstringEntry* inEntry,
+			      const GLint inRenderStyle,
+			      const GLboolean inKerning)
+{
+  if (!inEntry->chars || (inEntry->generation != This->generation)
+      || (inEntry->renderStyle != inRenderStyle)
+      || (inEntry->kerning != inKerning))
+    return NULL;
+
+  return inEntry->chars;
+}
+
+
+
+/* Store in 'inEntry' the 'inCount' characters that the rendering loop has
+ * resolved. If the memory can not be allocated, the characters are simply
+ * not cached.
+ */
+void __glcStringCacheSetCharacters(const __GLCstringCache* This,
+				   __GLCstringEntry* inEntry,
+				   const __GLCcharacter* inChars,
+				   const GLint inCount,
+				   const GLint inRenderStyle,
+				   const GLboolean inKerning)
+{
+  if (inCount > inEntry->charCount || !inEntry->chars) {
+    __GLCcharacter* chars = (__GLCcharacter*)__glcRealloc(inEntry->chars,
+					(inCount ? inCount : 1)
+					* sizeof(__GLCcharacter));
+
+    if (!chars)
+      return;
+    inEntry->chars = chars;
+  }
+
+  memcpy(inEntry->chars, inChars, inCount * sizeof(__GLCcharacter));
+  inEntry->charCount = inCount;
+  inEntry->generation = This->generation;
+  inEntry->renderStyle = inRenderStyle;
+  inEntry->kerning = inKerning;
+}
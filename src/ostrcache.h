@@ -0,0 +1,89 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * header of the object __GLCstringCache which keeps the strings that have been
+ * recently rendered or measured, converted in visual order, along with the
+ * characters that have been resolved by the rendering loop.
+ */
+
+#ifndef __glc_ostrcache_h
+#define __glc_ostrcache_h
+
+typedef struct __GLCstringCacheRec __GLCstringCache;
+typedef struct __GLCstringEntryRec __GLCstringEntry;
+
+struct __GLCstringEntryRec {
+  FT_ListNodeRec node;		/* Node of the LRU list */
+  GLCchar32 hash;		/* Hash value of the input string */
+  GLint stringType;		/* GLC_STRING_TYPE of the input string */
+  GLint size;			/* Size of the input string in bytes */
+  GLCchar8* string;		/* Copy of the input string */
+  GLCchar32* visualString;	/* String converted to UCS4 in visual order */
+  GLint length;			/* Number of characters of visualString */
+  GLboolean isRightToLeft;
+  /* Characters resolved by the rendering loop */
+  struct __GLCcharacterRec* chars;
+  GLint charCount;
+  GLuint generation;		/* Generation of the fonts of 'chars' */
+  GLint renderStyle;		/* GLC_RENDER_STYLE of 'chars' */
+  GLboolean kerning;		/* GLC_KERNING_QSO of 'chars' */
+};
+
+struct __GLCstringCacheRec {
+  FT_ListRec entryList;		/* Entries from the most recently used */
+  GLint entryCount;
+  GLuint generation;		/* Incremented when the fonts are modified */
+};
+
+__GLCstringCache* __glcStringCacheCreate(void);
+void __glcStringCacheDestroy(__GLCstringCache* This);
+__GLCstringEntry* __glcStringCacheLookup(__GLCstringCache* This,
+					 const GLCchar8* inString,
+					 const GLint inSize,
+					 const GLint inStringType);
+__GLCstringEntry* __glcStringCacheInsert(__GLCstringCache* This,
+					 const GLCchar8* inString,
+					 const GLint inSize,
+					 const GLint inStringType,
+					 const GLCchar32* inVisualString,
+					 const GLint inLength,
+					 const GLboolean inIsRightToLeft);
+const struct __GLCcharacterRec*
+__glcStringCacheGetCharacters(const __GLCstringCache* This,
+			      const __GLCstringEntry* inEntry,
+			      const GLint inRenderStyle,
+			      const GLboolean inKerning);
+void __glcStringCacheSetCharacters(const __GLCstringCache* This,
+				   __GLCstringEntry* inEntry,
+				   const struct __GLCcharacterRec* inChars,
+				   const GLint inCount,
+				   const GLint inRenderStyle,
+				   const GLboolean inKerning);
+
+/* Invalidate the characters resolved by the rendering loop : they are not
+ * released but they will be resolved again the next time that their string is
+ * rendered.
+ */
+static inline void __glcStringCacheInvalidate(__GLCstringCache* This)
+{
+  This->generation++;
+}
+#endif
@@ -0,0 +1,124 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * defines the object __GLCtext which stores a string that has been compiled
+ * by glcTextStringQSO() so that it can be drawn again by glcDrawTextQSO().
+ */
+
+/* The geometry of the string of a text object is laid out once in the
+ * coordinates of the text object and stored in a VBO and an IBO, so that it
+ * is drawn by a single call to glDrawElements(). The geometry is copied from
+ * the GL objects of the glyphs which may then be released or recycled. For
+ * the GLC_TEXTURE and GLC_SDF_QSO rendering styles, the VBO stores the
+ * coordinates of the glyphs in the texture atlas : their areas are pinned in
+ * the atlas as long as the text object uses them.
+ *
+ * If the GL implementation does not support VBOs, or for the GLC_BITMAP and
+ * GLC_PIXMAP_QSO rendering styles, the string is compiled in a GL display list
+ * while the internal management of the GL objects is disabled (as it is when
+ * the user builds its own display lists). Hence the display list stores the
+ * image of every textured glyph and uploads it each time it is called.
+ */
+
+#include "internal.h"
+#include "texture.h"
+
+
+
+/* Constructor of the object : the text object is initially empty */
+__GLCtext* __glcTextCreate(const GLint inID)
+{
+  __GLCtext* This = NULL;
+
+  This = (__GLCtext*)__glcMalloc(sizeof(__GLCtext));
+  if (!This) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    return NULL;
+  }
+
+  This->node.prev = NULL;
+  This->node.next = NULL;
+  This->node.data = This;
+  This->id = inID;
+  This->displayList = 0;
+  This->uploadCount = 0;
+  This->uploadBytes = 0;
+  This->bufferObjectID[0] = 0;
+  This->bufferObjectID[1] = 0;
+  This->renderStyle = 0;
+  This->extrude = GL_FALSE;
+  This->indexCount = 0;
+  This->capCount = 0;
+  This->resolution = 1.f;
+  This->advance[0] = 0.f;
+  This->advance[1] = 0.f;
+  This->atlasElements = NULL;
+
+  return This;
+}
+
+
+
+/* Destructor of the object */
+void __glcTextDestroy(__GLCtext* This, __GLCcontext* inContext)
+{
+  __glcTextDestroyGLObjects(This, inContext);
+  if (This->atlasElements)
+    __glcArrayDestroy(This->atlasElements);
+  __glcFree(This);
+}
+
+
+
+/* Release the GL objects of the text object and the areas of the texture atlas
+ * that it pins. The GL context may not be current during a global command
+ * (glcDeleteContext() for instance) so the GL objects are then just forgotten.
+ */
+void __glcTextDestroyGLObjects(__GLCtext* This, __GLCcontext* inContext)
+{
+  if (!inContext->isInGlobalCommand) {
+    if (This->displayList)
+      glDeleteLists(This->displayList, 1);
+    if (This->bufferObjectID[0])
+      glDeleteBuffersARB(2, This->bufferObjectID);
+  }
+
+  if (This->atlasElements) {
+    __GLCatlasElement** atlasElements =
+      (__GLCatlasElement**)GLC_ARRAY_DATA(This->atlasElements);
+    int i = 0;
+
+    for (i = 0; i < GLC_ARRAY_LENGTH(This->atlasElements); i++)
+      __glcUnpinAtlasElement(atlasElements[i], inContext);
+    GLC_ARRAY_LENGTH(This->atlasElements) = 0;
+  }
+
+  This->displayList = 0;
+  This->uploadCount = 0;
+  This->uploadBytes = 0;
+  This->bufferObjectID[0] = 0;
+  This->bufferObjectID[1] = 0;
+  This->renderStyle = 0;
+  This->indexCount = 0;
+  This->capCount = 0;
+  This->advance[0] = 0.f;
+  This->advance[1] = 0.f;
+}
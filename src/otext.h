@@ -0,0 +1,50 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * header of the object __GLCtext which stores a string that has been compiled
+ * by glcTextStringQSO() so that it can be drawn again by glcDrawTextQSO().
+ */
+
+#ifndef __glc_otext_h
+#define __glc_otext_h
+
+typedef struct __GLCtextRec __GLCtext;
+
+struct __GLCtextRec {
+  FT_ListNodeRec node;		/* Node of the list of the text objects */
+  GLint id;			/* ID of the text object */
+  GLuint displayList;		/* Display list which renders the string */
+  GLuint uploadCount;		/* Texture uploads replayed by the list */
+  GLuint uploadBytes;		/* Bytes uploaded by those texture uploads */
+  GLuint bufferObjectID[2];	/* VBO and IBO of the geometry of the string */
+  GLCenum renderStyle;		/* Rendering style of the geometry */
+  GLboolean extrude;		/* The GLC_TRIANGLE geometry is extruded */
+  GLsizei indexCount;		/* Indices drawn by glcDrawTextQSO() */
+  GLsizei capCount;		/* Indices of each cap of an extruded string */
+  GLfloat resolution;		/* GLC_RESOLUTION in dots per point */
+  GLfloat advance[2];		/* Advance of the string */
+  __GLCarray* atlasElements;	/* Areas of the texture atlas that are used */
+};
+
+__GLCtext* __glcTextCreate(const GLint inID);
+void __glcTextDestroy(__GLCtext* This, __GLCcontext* inContext);
+void __glcTextDestroyGLObjects(__GLCtext* This, __GLCcontext* inContext);
+#endif
@@ -110,15 +110,14 @@ static void __glcRenderCharBitmap(const __GLCfont* inFont,
   __glcFontGetBitmapSize(inFont, &pixWidth, &pixHeight, inScaleX, inScaleY, 0,
 			 pixBoundingBox, inContext);
 
-  pixBuffer = (GLubyte *)__glcMalloc(pixWidth * pixHeight);
-  if (!pixBuffer) {
-    __glcRaiseError(GLC_RESOURCE_ERROR);
+  pixBuffer = (GLubyte *)__glcArenaAlloc(inContext->arena,
+					 pixWidth * pixHeight);
+  if (!pixBuffer)
     return;
-  }
 
   /* render the glyph */
   if (!__glcFontGetBitmap(inFont, pixWidth, pixHeight, pixBuffer, inContext)) {
-    __glcFree(pixBuffer);
+    __glcArenaFree(inContext->arena, pixBuffer);
     return;
   }
 
@@ -137,8 +136,9 @@ static void __glcRenderCharBitmap(const __GLCfont* inFont,
 	     inAdvance[0] * transform[0] + inAdvance[1] * transform[2],
 	     inAdvance[0] * transform[1] + inAdvance[1] * transform[3],
 	     pixBuffer);
+  GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
 
-  __glcFree(pixBuffer);
+  __glcArenaFree(inContext->arena, pixBuffer);
 }
 
 
@@ -158,15 +158,14 @@ static void __glcRenderCharPixmap(const __GLCfont* inFont,
   __glcFontGetBitmapSize(inFont, &pixWidth, &pixHeight, scaleX, scaleY, 0,
 			 pixBoundingBox, inContext);
 
-  pixBuffer = (GLubyte *)__glcMalloc(pixWidth * pixHeight);
-  if (!pixBuffer) {
-    __glcRaiseError(GLC_RESOURCE_ERROR);
+  pixBuffer = (GLubyte *)__glcArenaAlloc(inContext->arena,
+					 pixWidth * pixHeight);
+  if (!pixBuffer)
     return;
-  }
 
   /* render the glyph */
   if (!__glcFontGetBitmap(inFont, pixWidth, pixHeight, pixBuffer, inContext)) {
-    __glcFree(pixBuffer);
+    __glcArenaFree(inContext->arena, pixBuffer);
     return;
   }
 
@@ -180,6 +179,7 @@ static void __glcRenderCharPixmap(const __GLCfont* inFont,
 	     NULL);
 
     glDrawPixels(pixWidth, pixHeight, GL_ALPHA, GL_UNSIGNED_BYTE, pixBuffer);
+    GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
 
     glBitmap(0, 0, 0.f, 0.f,
 	     -(pixBoundingBox[0] >> 6),
@@ -193,6 +193,7 @@ static void __glcRenderCharPixmap(const __GLCfont* inFont,
 	     NULL);
 
     glDrawPixels(pixWidth, pixHeight, GL_ALPHA, GL_UNSIGNED_BYTE, pixBuffer);
+    GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
 
     glBitmap(0, 0, 0.f, 0.f,
 	     advance[0] * transform[0] + advance[1] * transform[2] - 
@@ -202,7 +203,7 @@ static void __glcRenderCharPixmap(const __GLCfont* inFont,
 	     NULL);
   }
 
-  __glcFree(pixBuffer);
+  __glcArenaFree(inContext->arena, pixBuffer);
 }
 
 
@@ -319,6 +320,7 @@ static void* __glcRenderChar(const GLint inCode, const GLint inPrevCode,
 			  inIsRTL);
     break;
   case GLC_TEXTURE:
+  case GLC_SDF_QSO:
     __glcRenderCharTexture(inFont, inContext, scaleX, scaleY, glyph);
     break;
   case GLC_LINE:
@@ -348,20 +350,215 @@ static void* __glcRenderChar(const GLint inCode, const GLint inPrevCode,
 
 
 
+/* This internal function renders the characters that have been resolved by
+ * __glcRenderCountedString() with the texture atlas. The quads of the glyphs
+ * are read in order from the render records of their faces and laid out in a
+ * single vertex array, so that the whole batch is drawn with one call.
+ */
+static void __glcRenderTexturedCharacters(__GLCcontext* inContext,
+					  const __GLCcharacter* inChars,
+					  const GLint inLength,
+					  const GLboolean inIsRightToLeft)
+{
+  GLfloat* quads = NULL;
+  GLfloat* data = NULL;
+  GLfloat pen[2] = {0.f, 0.f};
+  GLint j = 0;
+
+  quads = (GLfloat*)__glcArenaAlloc(inContext->arena,
+				    inLength * 20 * sizeof(GLfloat));
+  if (!quads) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    return;
+  }
+
+  data = quads;
+  for (j = 0; j < inLength; j++) {
+    if (inIsRightToLeft) {
+      pen[0] -= inChars[j].advance[0];
+      pen[1] += inChars[j].advance[1];
+    }
+    if (inChars[j].code != 32) {
+      __glcAtlasRectToQuad(data,
+			   inChars[j].records->atlasRect[inChars[j].record],
+			   pen[0], pen[1]);
+      data += 20;
+    }
+    if (!inIsRightToLeft) {
+      pen[0] += inChars[j].advance[0];
+      pen[1] += inChars[j].advance[1];
+    }
+  }
+
+  if (data != quads) {
+    /* The vertex array is stored in client memory : unbind the VBO of the
+     * atlas which __glcRenderCharTexture() binds again when it needs it.
+     */
+    if (GLEW_ARB_vertex_buffer_object)
+      glBindBufferARB(GL_ARRAY_BUFFER_ARB, 0);
+    glInterleavedArrays(GL_T2F_V3F, 0, quads);
+    glDrawArrays(GL_QUADS, 0, (GLsizei)((data - quads) / 5));
+    GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
+  }
+
+  glTranslatef(pen[0], pen[1], 0.f);
+  __glcArenaFree(inContext->arena, quads);
+}
+
+
+
+/* This internal function renders the characters that have been resolved by
+ * __glcRenderCountedString() with the GL objects of their glyphs.
+ */
+static void __glcRenderCharacters(__GLCcontext* inContext,
+				  const __GLCcharacter* inChars,
+				  const GLint inLength,
+				  const GLboolean inIsRightToLeft,
+				  const GLuint inGLObjectIndex,
+				  const GLfloat inResolution,
+				  GLfloat* ioOrientation)
+{
+  __GLCglyph* glyph = NULL;
+  GLint j = 0;
+
+  if (GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)) {
+    __glcRenderTexturedCharacters(inContext, inChars, inLength,
+				  inIsRightToLeft);
+    return;
+  }
+
+  for (j = 0; j < inLength; j++) {
+    if (inIsRightToLeft)
+      glTranslatef(-inChars[j].advance[0], inChars[j].advance[1], 0.);
+    if (inChars[j].code != 32) {
+      glyph = inChars[j].glyph;
+
+      switch(inContext->renderState.renderStyle) {
+      case GLC_LINE:
+	if (GLEW_ARB_vertex_buffer_object) {
+	  int k = 0;
+
+	  glBindBufferARB(GL_ARRAY_BUFFER_ARB, glyph->glObject[0]);
+	  glVertexPointer(2, GL_FLOAT, 0, NULL);
+	  for (k = 0; k < glyph->nContour; k++)
+	    glDrawArrays(GL_LINE_LOOP, glyph->contours[k],
+			 glyph->contours[k+1] - glyph->contours[k]);
+	  GLC_STAT_ADD(inContext, GLC_DRAW_CALL_COUNT_QSO, glyph->nContour);
+	  break;
+	}
+	glCallList(glyph->glObject[0]);
+	GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
+	break;
+      case GLC_TRIANGLE:
+	if (GLEW_ARB_vertex_buffer_object) {
+	  int k = 0;
+	  GLboolean extrude = GL_FALSE;
+
+	  glBindBufferARB(GL_ARRAY_BUFFER_ARB, glyph->glObject[0]);
+	  glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,
+			  glyph->glObject[2]);
+	  glVertexPointer(2, GL_FLOAT, 0, NULL);
+
+	  do {
+	    GLuint* vertexIndices = NULL;
+
+	    if (*ioOrientation > 0.f) {
+	      for (k = 0; k < glyph->nGeomBatch; k++) {
+		glDrawRangeElements(glyph->geomBatches[k].mode,
+				    glyph->geomBatches[k].start,
+				    glyph->geomBatches[k].end,
+				    glyph->geomBatches[k].length,
+				    GL_UNSIGNED_INT, vertexIndices);
+		vertexIndices += glyph->geomBatches[k].length;
+	      }
+	      GLC_STAT_ADD(inContext, GLC_DRAW_CALL_COUNT_QSO,
+			   glyph->nGeomBatch);
+	    }
+
+	    if (inContext->enableState.extrude) {
+	      if (extrude) {
+		glTranslatef(0.f, 0.f, 1.f);
+		glBindBufferARB(GL_ARRAY_BUFFER_ARB,
+				glyph->glObject[3]);
+		glInterleavedArrays(GL_N3F_V3F, 0, NULL);
+
+		for (k = 0; k < glyph->nContour; k++)
+		  glDrawArrays(GL_TRIANGLE_STRIP, glyph->contours[k] * 2,
+			       (glyph->contours[k+1] - glyph->contours[k]
+				+ 1) * 2);
+		GLC_STAT_ADD(inContext, GLC_DRAW_CALL_COUNT_QSO,
+			     glyph->nContour);
+		glNormal3f(0.f, 0.f, 1.f / inResolution);
+	      }
+	      else {
+		glNormal3f(0.f, 0.f, -1.f / inResolution);
+		glTranslatef(0.f, 0.f, -1.f);
+		*ioOrientation = -(*ioOrientation);
+	      }
+	      extrude = (!extrude);
+	    }
+	  } while(extrude);
+	}
+	else {
+	  glCallList(glyph->glObject[inGLObjectIndex]);
+	  GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
+	}
+
+	break;
+      }
+    }
+    if (!inIsRightToLeft)
+      glTranslatef(inChars[j].advance[0], inChars[j].advance[1], 0.);
+  }
+
+}
+
+
+
+/* Check that the GL objects of the glyphs of the characters 'inChars' still
+ * exist. The characters that have been kept in the string cache can then be
+ * rendered without being resolved again.
+ */
+static GLboolean __glcCharactersAreReady(const __GLCcharacter* inChars,
+					 const GLint inLength,
+					 const GLuint inGLObjectIndex)
+{
+  GLint j = 0;
+
+  for (j = 0; j < inLength; j++) {
+    if (inChars[j].code == 32)
+      continue;
+
+    /* The texture styles only need the quad of the glyph in the atlas */
+    if (inGLObjectIndex == 1) {
+      if (inChars[j].records->atlasVertex[inChars[j].record] < 0)
+	return GL_FALSE;
+    }
+    else if (!inChars[j].glyph->glObject[inGLObjectIndex])
+      return GL_FALSE;
+  }
+
+  return GL_TRUE;
+}
+
+
+
 /* This internal function is used by both glcRenderString() and
  * glcRenderCountedString(). The string 'inString' must be sorted in visual
- * order and stored using UCS4 format.
+ * order and stored using UCS4 format. 'inEntry' is the entry of the string in
+ * the string cache, or NULL if the string is not cached.
  */
 static void __glcRenderCountedString(__GLCcontext* inContext,
 				     const GLCchar32* inString,
 				     const GLboolean inIsRightToLeft,
-				     const GLint inCount)
+				     const GLint inCount,
+				     __GLCstringEntry* inEntry)
 {
   GLint listIndex = 0;
   GLint i = 0;
   const GLCchar32* ptr = NULL;
   __GLCglState GLState;
-  __GLCcharacter prevCode = {0, NULL, NULL, {0.f, 0.f}};
+  __GLCcharacter prevCode = {0, 0, NULL, NULL, NULL, {0.f, 0.f}};
   GLboolean saveGLObjects = GL_FALSE;
   GLint shift = 1;
   __GLCcharacter* chars = NULL;
@@ -383,11 +580,10 @@ static void __glcRenderCountedString(__GLCcontext* inContext,
   if (inContext->enableState.glObjects
       && (inContext->renderState.renderStyle != GLC_BITMAP)
       && (inContext->renderState.renderStyle != GLC_PIXMAP_QSO)) {
-    chars = (__GLCcharacter*)__glcMalloc(inCount * sizeof(__GLCcharacter));
-    if (!chars) {
-      __glcRaiseError(GLC_RESOURCE_ERROR);
+    chars = (__GLCcharacter*)__glcArenaAlloc(inContext->arena,
+					     inCount * sizeof(__GLCcharacter));
+    if (!chars)
       return;
-    }
   }
 
   /* Save the value of the GL parameters */
@@ -412,12 +608,31 @@ static void __glcRenderCountedString(__GLCcontext* inContext,
       && inContext->enableState.glObjects && inContext->enableState.extrude)
     glEnable(GL_NORMALIZE);
 
-  /* Set the texture environment if the render style is GLC_TEXTURE */
-  if (inContext->renderState.renderStyle == GLC_TEXTURE) {
+  /* Set the texture environment if the render style is GLC_TEXTURE or
+   * GLC_SDF_QSO
+   */
+  if (GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)) {
+    /* GLC_TEXTURE and GLC_SDF_QSO share the texture atlas but do not store the
+     * same data in it : the atlas must be emptied when it has been filled for
+     * the other style, whatever the styles used in between (including the
+     * styles restored by glcPopAttribQSO()).
+     */
+    if (inContext->atlasStyle != inContext->renderState.renderStyle) {
+      __glcTextureAtlasFlush(inContext);
+      inContext->atlasStyle = inContext->renderState.renderStyle;
+    }
+
     /* Set the new values of the parameters */
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    if (inContext->renderState.renderStyle == GLC_SDF_QSO) {
+      /* The texels store the distance to the outline of the glyph which is
+       * located at the 0.5 iso-value. The texture is cut along this iso-value
+       * whatever the magnification of the glyph is.
+       */
+      __glcTextureEnableSdf(inContext, inContext->enableState.glObjects);
+    }
     if (inContext->enableState.glObjects) {
       if (inContext->atlas.id)
 	glBindTexture(GL_TEXTURE_2D, inContext->atlas.id);
@@ -430,9 +645,16 @@ static void __glcRenderCountedString(__GLCcontext* inContext,
     }
     else if (inContext->texture.id) {
       glBindTexture(GL_TEXTURE_2D, inContext->texture.id);
-      if (GLEW_ARB_pixel_buffer_object && inContext->texture.bufferObjectID)
-	glBindBufferARB(GL_PIXEL_UNPACK_BUFFER,
-			inContext->texture.bufferObjectID);
+      if (GLEW_ARB_pixel_buffer_object) {
+	/* The distance field is computed in client memory hence the PBO is not
+	 * used by the GLC_SDF_QSO rendering style.
+	 */
+	if (inContext->renderState.renderStyle == GLC_SDF_QSO)
+	  glBindBufferARB(GL_PIXEL_UNPACK_BUFFER, 0);
+	else if (inContext->texture.bufferObjectID)
+	  glBindBufferARB(GL_PIXEL_UNPACK_BUFFER,
+			  inContext->texture.bufferObjectID);
+      }
     }
   }
 
@@ -472,11 +694,14 @@ static void __glcRenderCountedString(__GLCcontext* inContext,
     __GLCfont* font = NULL;
     __GLCglyph* glyph = NULL;
     int length = 0;
-    int j = 0;
-    GLuint GLObjectIndex = inContext->renderState.renderStyle - 0x101;
+    GLuint GLObjectIndex =
+      GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle) ?
+      1 : inContext->renderState.renderStyle - 0x101;
     FT_ListNode node = NULL;
     float resolution = inContext->renderState.resolution / 72.;
     GLfloat orientation = 1.f;
+    GLboolean resolved = GL_TRUE;
+    const __GLCcharacter* cachedChars = NULL;
 
     if (inContext->renderState.renderStyle == GLC_TRIANGLE
 	&& inContext->enableState.extrude) {
@@ -495,155 +720,119 @@ static void __glcRenderCountedString(__GLCcontext* inContext,
 
     glNormal3f(0.f, 0.f, 1.f / resolution);
 
-    for (i = 0; i < inCount; i++) {
-      if (*ptr >= 32) {
- 	for (node = inContext->currentFontList.head; node ; node = node->next) {
- 	  font = (__GLCfont*)node->data;
- 	  glyph = __glcCharMapGetGlyph(font->charMap, *ptr);
-
- 	  if (glyph) {
- 	    if (!glyph->glObject[GLObjectIndex] && !glyph->isSpacingChar)
- 	      continue;
-
-	    if (!glyph->isSpacingChar
-		&& (inContext->renderState.renderStyle == GLC_TEXTURE))
-	      FT_List_Up(&inContext->atlasList,
-			 (FT_ListNode)glyph->textureObject);
-
-	    chars[length].glyph = glyph;
-	    chars[length].advance[0] = glyph->advance[0];
-	    chars[length].advance[1] = glyph->advance[1];
-
- 	    if (inContext->enableState.kerning) {
- 	      if (prevCode.code && prevCode.font == font) {
- 		GLfloat kerning[2];
-		GLint leftCode = inIsRightToLeft ? *ptr : prevCode.code;
-		GLint rightCode = inIsRightToLeft ? prevCode.code : *ptr;
-
- 		if (__glcFontGetKerning(font, leftCode, rightCode, kerning,
- 					inContext, GLC_POINT_SIZE,
- 					GLC_POINT_SIZE)) {
-		  if (inIsRightToLeft)
-		    kerning[0] = -kerning[0];
-
-		  if (length) {
-		    chars[length - 1].advance[0] += kerning[0];
-		    chars[length - 1].advance[1] += kerning[1];
-		  }
-		  else
-		    glTranslatef(kerning[0], kerning[1], 0.f);
- 		}
- 	      }
- 	    }
-
-	    prevCode.font = font;
-	    prevCode.code = *ptr;
-
-	    if (glyph->isSpacingChar)
-	      chars[length].code = 32;
-	    else
-	      chars[length].code = *ptr;
-
- 	    length++;
- 	    break;
- 	  }
- 	}
+    /* If the characters of the string have been kept in the string cache
+     * and if the GL objects of their glyphs still exist, they are rendered at
+     * once.
+     */
+    if (inEntry)
+      cachedChars =
+	__glcStringCacheGetCharacters(inContext->stringCache, inEntry,
+				      inContext->renderState.renderStyle,
+				      inContext->enableState.kerning);
+
+    if (cachedChars && __glcCharactersAreReady(cachedChars, inEntry->charCount,
+					       GLObjectIndex)) {
+      if (GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle)) {
+	for (i = 0; i < inEntry->charCount; i++) {
+	  if (cachedChars[i].code != 32)
+	    FT_List_Up(&inContext->atlasList,
+		       (FT_ListNode)cachedChars[i].glyph->textureObject);
+	}
       }
 
-      if(!node || (i == inCount-1)) {
-	glScalef(resolution, resolution, 1.f);
-
-	for (j = 0; j < length; j++) {
-	  if (inIsRightToLeft)
-	    glTranslatef(-chars[j].advance[0], chars[j].advance[1], 0.);
-	  if (chars[j].code != 32) {
-	    glyph = chars[j].glyph;
-
-	    switch(inContext->renderState.renderStyle) {
-	    case GLC_TEXTURE:
-	      if (GLEW_ARB_vertex_buffer_object)
-		glDrawArrays(GL_QUADS, glyph->textureObject->position * 4, 4);
-	      else
-		glCallList(glyph->glObject[1]);
-	      break;
-	    case GLC_LINE:
-	      if (GLEW_ARB_vertex_buffer_object) {
-		int k = 0;
-
-		glBindBufferARB(GL_ARRAY_BUFFER_ARB, glyph->glObject[0]);
-		glVertexPointer(2, GL_FLOAT, 0, NULL);
-		for (k = 0; k < glyph->nContour; k++)
-		  glDrawArrays(GL_LINE_LOOP, glyph->contours[k],
-			       glyph->contours[k+1] - glyph->contours[k]);
-		break;
-	      }
-	      glCallList(glyph->glObject[0]);
-	      break;
-	    case GLC_TRIANGLE:
-	      if (GLEW_ARB_vertex_buffer_object) {
-		int k = 0;
-		GLboolean extrude = GL_FALSE;
-
-		glBindBufferARB(GL_ARRAY_BUFFER_ARB, glyph->glObject[0]);
-		glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB,
-				glyph->glObject[2]);
-		glVertexPointer(2, GL_FLOAT, 0, NULL);
-
-		do {
-		  GLuint* vertexIndices = NULL;
-
-		  if (orientation > 0.f) {
-		    for (k = 0; k < glyph->nGeomBatch; k++) {
-		      glDrawRangeElements(glyph->geomBatches[k].mode,
-					  glyph->geomBatches[k].start,
-					  glyph->geomBatches[k].end,
-					  glyph->geomBatches[k].length,
-					  GL_UNSIGNED_INT, vertexIndices);
-		      vertexIndices += glyph->geomBatches[k].length;
-		    }
-		  }
-
-		  if (inContext->enableState.extrude) {
-		    if (extrude) {
-		      glTranslatef(0.f, 0.f, 1.f);
-		      glBindBufferARB(GL_ARRAY_BUFFER_ARB,
-				      glyph->glObject[3]);
-		      glInterleavedArrays(GL_N3F_V3F, 0, NULL);
-
-		      for (k = 0; k < glyph->nContour; k++)
-			glDrawArrays(GL_TRIANGLE_STRIP, glyph->contours[k] * 2,
-				     (glyph->contours[k+1] - glyph->contours[k]
-				      + 1) * 2);
-		      glNormal3f(0.f, 0.f, 1.f / resolution);
-		    }
-		    else {
-		      glNormal3f(0.f, 0.f, -1.f / resolution);
-		      glTranslatef(0.f, 0.f, -1.f);
-		      orientation = -orientation;
+      glScalef(resolution, resolution, 1.f);
+      __glcRenderCharacters(inContext, cachedChars, inEntry->charCount,
+			    inIsRightToLeft, GLObjectIndex, resolution,
+			    &orientation);
+      glScalef(1./resolution, 1./resolution, 1.f);
+    }
+    else {
+      for (i = 0; i < inCount; i++) {
+	if (*ptr >= 32) {
+	  for (node = inContext->currentFontList.head; node;
+	       node = node->next) {
+	    font = (__GLCfont*)node->data;
+	    glyph = __glcCharMapGetGlyph(font->charMap, *ptr);
+
+	    if (glyph) {
+	      if (!glyph->glObject[GLObjectIndex] && !glyph->isSpacingChar)
+		continue;
+
+	      if (!glyph->isSpacingChar
+		  && GLC_IS_TEXTURE_STYLE(inContext->renderState.renderStyle))
+		FT_List_Up(&inContext->atlasList,
+			   (FT_ListNode)glyph->textureObject);
+
+	      chars[length].glyph = glyph;
+	      chars[length].records = glyph->records;
+	      chars[length].record = glyph->record;
+	      memcpy(chars[length].advance,
+		     glyph->records->advance[glyph->record],
+		     2 * sizeof(GLfloat));
+
+	      if (inContext->enableState.kerning) {
+		if (prevCode.code && prevCode.font == font) {
+		  GLfloat kerning[2];
+		  GLint leftCode = inIsRightToLeft ? *ptr : prevCode.code;
+		  GLint rightCode = inIsRightToLeft ? prevCode.code : *ptr;
+
+		  if (__glcFontGetKerning(font, leftCode, rightCode, kerning,
+					  inContext, GLC_POINT_SIZE,
+					  GLC_POINT_SIZE)) {
+		    if (inIsRightToLeft)
+		      kerning[0] = -kerning[0];
+
+		    if (length) {
+		      chars[length - 1].advance[0] += kerning[0];
+		      chars[length - 1].advance[1] += kerning[1];
 		    }
-		    extrude = (!extrude);
+		    else
+		      glTranslatef(kerning[0], kerning[1], 0.f);
 		  }
-		} while(extrude);
+		}
 	      }
+
+	      prevCode.font = font;
+	      prevCode.code = *ptr;
+
+	      if (glyph->isSpacingChar)
+		chars[length].code = 32;
 	      else
-		glCallList(glyph->glObject[GLObjectIndex]);
+		chars[length].code = *ptr;
 
+	      length++;
 	      break;
 	    }
 	  }
-	  if (!inIsRightToLeft)
-	    glTranslatef(chars[j].advance[0], chars[j].advance[1], 0.);
 	}
 
-	if (!node)
-	  __glcProcessChar(inContext, *ptr, &prevCode, inIsRightToLeft,
-			   __glcRenderChar, NULL);
+	if(!node || (i == inCount-1)) {
+	  glScalef(resolution, resolution, 1.f);
 
-	glScalef(1./resolution, 1./resolution, 1.f);
-	length = 0;
-      }
+	  __glcRenderCharacters(inContext, chars, length, inIsRightToLeft,
+				GLObjectIndex, resolution, &orientation);
 
-      ptr += shift;
+	  if (!node) {
+	    __glcProcessChar(inContext, *ptr, &prevCode, inIsRightToLeft,
+			     __glcRenderChar, NULL);
+	    resolved = GL_FALSE;
+	  }
+	  else if (inEntry && resolved) {
+	    /* The whole string has been resolved in a single batch : keep its
+	     * characters in the string cache.
+	     */
+	    __glcStringCacheSetCharacters(inContext->stringCache, inEntry, chars,
+					  length,
+					  inContext->renderState.renderStyle,
+					  inContext->enableState.kerning);
+	  }
+
+	  glScalef(1./resolution, 1./resolution, 1.f);
+	  length = 0;
+	}
+
+	ptr += shift;
+      }
     }
   }
   else {
@@ -663,10 +852,22 @@ static void __glcRenderCountedString(__GLCcontext* inContext,
   if ((inContext->renderState.renderStyle != GLC_BITMAP)
       && (inContext->renderState.renderStyle != GLC_PIXMAP_QSO)
       && inContext->enableState.glObjects)
-      __glcFree(chars);
+      __glcArenaFree(inContext->arena, chars);
 
   if (listIndex)
     inContext->enableState.glObjects = saveGLObjects;
+
+  /* Release the transient buffers of the command, unless it has been issued
+   * from a callback function in which case the calling command still needs
+   * its buffers. The scratch arrays are trimmed at the same time, so that the
+   * memory taken by unusually large glyphs is released once per command
+   * rather than reallocated for every such glyph.
+   */
+  if (!inContext->isInCallbackFunc) {
+    __glcArenaReset(inContext->arena);
+    __glcArrayShrink(inContext->vertexArray, GLC_ARRAY_HIGH_WATER);
+    __glcArrayShrink(inContext->vertexIndices, GLC_ARRAY_HIGH_WATER);
+  }
 }
 
 
@@ -699,7 +900,7 @@ void APIENTRY glcRenderChar(GLint inCode)
   if (code < 32)
     return; /* Skip control characters and unknown characters */
 
-  __glcRenderCountedString(ctx, (GLCchar32*)&code, GL_FALSE, 1);
+  __glcRenderCountedString(ctx, (GLCchar32*)&code, GL_FALSE, 1, NULL);
 }
 
 
@@ -722,6 +923,7 @@ void APIENTRY glcRenderCountedString(GLint inCount, const GLCchar *inString)
   __GLCcontext *ctx = NULL;
   GLCchar32* UinString = NULL;
   GLboolean isRightToLeft = GL_FALSE;
+  __GLCstringEntry* entry = NULL;
 
   GLC_INIT_THREAD();
 
@@ -746,12 +948,12 @@ void APIENTRY glcRenderCountedString(GLint inCount, const GLCchar *inString)
    * that means that inString is read in the current string format.
    */
   UinString = __glcConvertCountedStringToVisualUcs4(ctx, &isRightToLeft,
-						    inString, inCount);
+						    inString, inCount, &entry);
   if (!UinString)
     return;
 
 
-  __glcRenderCountedString(ctx, UinString, isRightToLeft, inCount);
+  __glcRenderCountedString(ctx, UinString, isRightToLeft, inCount, entry);
 }
 
 
@@ -768,6 +970,7 @@ void APIENTRY glcRenderString(const GLCchar *inString)
   __GLCcontext *ctx = NULL;
   GLCchar32* UinString = NULL;
   GLboolean isRightToLeft = GL_FALSE;
+  __GLCstringEntry* entry = NULL;
   GLint length = 0;
 
   GLC_INIT_THREAD();
@@ -786,11 +989,106 @@ void APIENTRY glcRenderString(const GLCchar *inString)
   /* Creates a Unicode string based on the current string type. Basically,
    * that means that inString is read in the current string format.
    */
-  UinString = __glcConvertToVisualUcs4(ctx, &isRightToLeft, &length, inString);
+  UinString = __glcConvertToVisualUcs4(ctx, &isRightToLeft, &length, inString,
+				       &entry);
   if (!UinString)
     return;
 
-  __glcRenderCountedString(ctx, UinString, isRightToLeft, length);
+  __glcRenderCountedString(ctx, UinString, isRightToLeft, length, entry);
+}
+
+
+
+/** \ingroup render
+ *  This command renders the paragraph laid out by the last call to
+ *  glcLayoutParagraphQSO(), one line after the other. The paragraph is not
+ *  measured again : the characters of each line are those computed by
+ *  glcLayoutParagraphQSO() and the spaces at the end of a line are not
+ *  rendered.
+ *
+ *  Each line starts at the origin of the paragraph moved by \e inLineSpacing
+ *  times the number of lines above it along the negative y axis. The spacing
+ *  is expressed in the units of the metrics of the GLC measurement buffer ; it
+ *  is transformed by \b GLC_BITMAP_MATRIX when the render style is
+ *  \b GLC_BITMAP or \b GLC_PIXMAP_QSO. When the command returns, the origin is
+ *  at the beginning of the line that follows the paragraph.
+ *
+ *  The lines of a right to left paragraph are rendered from their origin
+ *  towards the left, so that they are aligned on the right.
+ *  \param inLineSpacing The distance between the baselines of two lines.
+ *  \sa glcLayoutParagraphQSO()
+ *  \sa glcRenderCountedString()
+ */
+void APIENTRY glcRenderParagraphQSO(GLfloat inLineSpacing)
+{
+  __GLCcontext *ctx = NULL;
+  GLCchar32* string = NULL;
+  __GLCline* lines = NULL;
+  GLint length = 0;
+  GLint lineCount = 0;
+  GLboolean isBitmap = GL_FALSE;
+  GLfloat origin[4] = {0.f, 0.f, 0.f, 0.f};
+  GLint i = 0;
+
+  GLC_INIT_THREAD();
+
+  /* Check if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return;
+  }
+
+  /* If no paragraph has been laid out then there is nothing to render */
+  if (!ctx->paragraphLines || !GLC_ARRAY_LENGTH(ctx->paragraphLines))
+    return;
+
+  string = (GLCchar32*)GLC_ARRAY_DATA(ctx->paragraphString);
+  length = GLC_ARRAY_LENGTH(ctx->paragraphString);
+  lines = (__GLCline*)GLC_ARRAY_DATA(ctx->paragraphLines);
+  lineCount = GLC_ARRAY_LENGTH(ctx->paragraphLines);
+
+  isBitmap = (ctx->renderState.renderStyle == GLC_BITMAP)
+    || (ctx->renderState.renderStyle == GLC_PIXMAP_QSO);
+
+  /* The raster position is moved in window coordinates : the origin of the
+   * paragraph is needed to locate the beginning of each line.
+   */
+  if (isBitmap)
+    glGetFloatv(GL_CURRENT_RASTER_POSITION, origin);
+
+  for (i = 0; i < lineCount; i++) {
+    /* The characters are stored in visual order : the line of a right to left
+     * paragraph is at the other end of the string.
+     */
+    GLint first = ctx->paragraphIsRTL ?
+      length - lines[i].start - lines[i].drawCount : lines[i].start;
+
+    if (isBitmap) {
+      GLfloat position[4];
+      GLfloat shift = -(i + 1) * inLineSpacing;
+
+      if (lines[i].drawCount)
+	__glcRenderCountedString(ctx, string + first, ctx->paragraphIsRTL,
+				 lines[i].drawCount, NULL);
+
+      /* Move the raster position to the beginning of the next line */
+      glGetFloatv(GL_CURRENT_RASTER_POSITION, position);
+      glBitmap(0, 0, 0, 0,
+	       origin[0] + ctx->bitmapMatrix[2] * shift - position[0],
+	       origin[1] + ctx->bitmapMatrix[3] * shift - position[1], NULL);
+    }
+    else {
+      glPushMatrix();
+      if (lines[i].drawCount)
+	__glcRenderCountedString(ctx, string + first, ctx->paragraphIsRTL,
+				 lines[i].drawCount, NULL);
+      glPopMatrix();
+
+      /* Move the origin to the beginning of the next line */
+      glTranslatef(0.f, -inLineSpacing, 0.f);
+    }
+  }
 }
 
 
@@ -820,8 +1118,21 @@ void APIENTRY glcRenderString(const GLCchar *inString)
  *    <tr>
  *      <td><b>GLC_PIXMAP_QSO</b></td> <td>0x8011</td>
  *    </tr>
+ *    <tr>
+ *      <td><b>GLC_SDF_QSO</b></td> <td>0x8012</td>
+ *    </tr>
  *  </table>
  *  </center>
+ *
+ *  The rendering style \b GLC_SDF_QSO works like \b GLC_TEXTURE except that
+ *  the texture atlas stores the signed distance field of the glyphs rather
+ *  than their coverage. The glyphs remain sharp whatever their scale and their
+ *  orientation are. If the extension GL_ARB_fragment_program is supported, the
+ *  field has one channel per color (red, green and blue) and the edges of the
+ *  glyphs are colored so that the median of the 3 channels keeps the corners
+ *  sharp : the glyphs are then drawn with a fragment program that discards
+ *  the fragments whose median is below 0.5. Otherwise the field has a single
+ *  channel and the glyphs are drawn with the alpha test enabled.
  *  \param inStyle The value to assign to the variable \b GLC_RENDER_STYLE.
  *  \sa glcGeti() with argument \b GLC_RENDER_STYLE
  */
@@ -838,6 +1149,7 @@ void APIENTRY glcRenderStyle(GLCenum inStyle)
   case GLC_TEXTURE:
   case GLC_TRIANGLE:
   case GLC_PIXMAP_QSO:
+  case GLC_SDF_QSO:
     break;
   default:
     __glcRaiseError(GLC_PARAMETER_ERROR);
@@ -934,8 +1246,6 @@ void APIENTRY glcResolution(GLfloat inVal)
     __GLCfaceDescriptor* faceDesc = font->faceDesc;
     FT_ListNode glyphNode = NULL;
 
-    font->maxMetricCached = GL_FALSE;
-
     for (glyphNode = faceDesc->glyphList.head; glyphNode;
 	 glyphNode = glyphNode->next) {
       __GLCglyph* glyph = (__GLCglyph*)glyphNode->data;
@@ -945,6 +1255,9 @@ void APIENTRY glcResolution(GLfloat inVal)
     }
   }
 
+  /* The advances of the characters of the cached strings must be updated */
+  __glcStringCacheInvalidate(ctx->stringCache);
+
   return;
 }
 
@@ -994,3 +1307,860 @@ void APIENTRY glcRenderParameterfQSO(GLenum inAttrib, GLfloat inVal)
   ctx->renderState.tolerance = inVal;
   return;
 }
+
+
+
+/* Check that the current thread owns a context state and that the text object
+ * identified by 'inText' exists. Returns the text object or NULL if an error
+ * has been raised.
+ */
+static __GLCtext* __glcVerifyTextParameters(const GLint inText)
+{
+  FT_ListNode node = NULL;
+  __GLCcontext *ctx = GLC_GET_CURRENT_CONTEXT();
+
+  /* Check if the current thread owns a context state */
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return NULL;
+  }
+
+  for (node = ctx->textList.head; node; node = node->next) {
+    if (((__GLCtext*)node)->id == inText)
+      return (__GLCtext*)node;
+  }
+
+  __glcRaiseError(GLC_PARAMETER_ERROR);
+  return NULL;
+}
+
+
+
+/** \ingroup render
+ *  This command returns a text object ID that is not used by the current
+ *  context. It creates an empty text object for the returned ID so that this
+ *  ID become used.
+ *
+ *  A text object stores a string which is laid out and compiled once by
+ *  glcTextStringQSO() and which can then be drawn many times by
+ *  glcDrawTextQSO() at the cost of a single GL call.
+ *  \return A new text object ID
+ *  \sa glcTextStringQSO()
+ *  \sa glcDrawTextQSO()
+ *  \sa glcDeleteTextQSO()
+ */
+GLint APIENTRY glcGenTextQSO(void)
+{
+  __GLCcontext *ctx = NULL;
+  __GLCtext* text = NULL;
+  FT_ListNode node = NULL;
+  GLint id = 1;
+
+  GLC_INIT_THREAD();
+
+  /* Verify if the current thread owns a context state */
+  ctx = GLC_GET_CURRENT_CONTEXT();
+  if (!ctx) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return 0;
+  }
+
+  /* Look for an ID which is not associated to an existing text object */
+  for (id = 1; id <= 0x7fffffff; id++) {
+    for (node = ctx->textList.head; node; node = node->next) {
+      if (((__GLCtext*)node)->id == id)
+	break;
+    }
+
+    if (!node)
+      break;
+  }
+
+  if (node) {
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+    return 0;
+  }
+
+  text = __glcTextCreate(id);
+  if (!text)
+    return 0;
+
+  FT_List_Add(&ctx->textList, &text->node);
+
+  return id;
+}
+
+
+
+typedef struct __GLCtextLayoutRec __GLCtextLayout;
+
+/* State of the layout of the string of a text object by glcTextStringQSO() */
+struct __GLCtextLayoutRec {
+  __GLCtext* text;
+  GLuint GLObjectIndex;		/* GL object of the glyphs which is used */
+  GLint stride;			/* Number of GLfloat per vertex */
+  __GLCarray* vertices;
+  __GLCarray* indices[3];	/* Front cap (or whole geometry), sides and back
+				 * cap of the string */
+  GLfloat pen[2];
+  GLboolean error;
+};
+
+
+
+/* Read the content of the buffer object 'inID' that is bound to 'inTarget'.
+ * The content is returned in a buffer of the arena and its size in 'outSize'.
+ */
+static void* __glcReadBufferObject(__GLCcontext* inContext,
+				   const GLenum inTarget, const GLuint inID,
+				   GLint* outSize)
+{
+  void* data = NULL;
+
+  glBindBufferARB(inTarget, inID);
+  glGetBufferParameterivARB(inTarget, GL_BUFFER_SIZE_ARB, outSize);
+
+  data = __glcArenaAlloc(inContext->arena, *outSize);
+  if (data)
+    glGetBufferSubDataARB(inTarget, 0, *outSize, data);
+
+  return data;
+}
+
+
+
+/* Append to 'ioIndices' the triangles of the primitive 'inMode' whose vertices
+ * are given by 'inIndices' (or are numbered from 0 if 'inIndices' is NULL)
+ * offset by 'inBase'.
+ */
+static GLboolean __glcAppendTriangles(__GLCarray* ioIndices,
+				      const GLenum inMode,
+				      const GLuint* inIndices,
+				      const GLint inLength, const GLuint inBase)
+{
+  GLuint* triangles = NULL;
+  GLint count = (inMode == GL_TRIANGLES) ? inLength : 3 * (inLength - 2);
+  GLint i = 0;
+
+  if (count <= 0)
+    return GL_TRUE;
+
+  triangles = (GLuint*)__glcArrayInsertCell(ioIndices,
+					    GLC_ARRAY_LENGTH(ioIndices), count);
+  if (!triangles)
+    return GL_FALSE;
+
+  for (i = 0; i < count; i++) {
+    GLint j = i;
+
+    switch(inMode) {
+    case GL_TRIANGLE_STRIP:
+      /* Every other triangle of the strip is flipped to keep the winding */
+      j = i / 3 + i % 3;
+      if ((i / 3) & 1 && i % 3 < 2)
+	j = i / 3 + 1 - i % 3;
+      break;
+    case GL_TRIANGLE_FAN:
+      j = (i % 3) ? i / 3 + i % 3 : 0;
+      break;
+    }
+
+    triangles[i] = (inIndices ? inIndices[j] : (GLuint)j) + inBase;
+  }
+
+  return GL_TRUE;
+}
+
+
+
+/* Append to the layout 'inLayout' the geometry of the glyph 'inGlyph' drawn at
+ * the current position of the pen. The geometry is copied from the GL objects
+ * of the glyph.
+ */
+static GLboolean __glcLayoutGlyph(__GLCtextLayout* inLayout,
+				  __GLCcontext* inContext,
+				  __GLCglyph* inGlyph)
+{
+  __GLCtext* text = inLayout->text;
+  GLuint base = GLC_ARRAY_LENGTH(inLayout->vertices) / inLayout->stride;
+  GLfloat* vertices = NULL;
+  GLfloat* data = NULL;
+  GLint size = 0;
+  GLint i = 0;
+  GLint k = 0;
+
+  switch(text->renderStyle) {
+  case GLC_TEXTURE:
+  case GLC_SDF_QSO:
+    {
+      static const GLuint quad[6] = {0, 1, 2, 0, 2, 3};
+
+      /* The area of the glyph must remain in the atlas as long as the text
+       * object uses it.
+       */
+      if (!__glcArrayAppend(text->atlasElements, &inGlyph->textureObject))
+	return GL_FALSE;
+      __glcPinAtlasElement(inGlyph->textureObject, inContext);
+
+      vertices = (GLfloat*)__glcArrayInsertCell(inLayout->vertices,
+				      GLC_ARRAY_LENGTH(inLayout->vertices), 20);
+      if (!vertices)
+	return GL_FALSE;
+
+      __glcAtlasRectToQuad(vertices,
+			   inGlyph->records->atlasRect[inGlyph->record],
+			   inLayout->pen[0], inLayout->pen[1]);
+      return __glcAppendTriangles(inLayout->indices[0], GL_TRIANGLES, quad, 6,
+				  base);
+    }
+  case GLC_LINE:
+    {
+      GLuint* indices = NULL;
+      GLint nVertex = inGlyph->contours[inGlyph->nContour];
+
+      /* The VBO also stores the vertices that the tesselator has added after
+       * the vertices of the contours.
+       */
+      data = (GLfloat*)__glcReadBufferObject(inContext, GL_ARRAY_BUFFER_ARB,
+					     inGlyph->glObject[0], &size);
+      if (!data)
+	return GL_FALSE;
+
+      vertices = (GLfloat*)__glcArrayInsertCell(inLayout->vertices,
+				      GLC_ARRAY_LENGTH(inLayout->vertices),
+				      2 * nVertex);
+      indices = (GLuint*)__glcArrayInsertCell(inLayout->indices[0],
+				      GLC_ARRAY_LENGTH(inLayout->indices[0]),
+				      2 * nVertex);
+      if (!vertices || !indices) {
+	__glcArenaFree(inContext->arena, data);
+	return GL_FALSE;
+      }
+
+      for (i = 0; i < nVertex; i++) {
+	vertices[2 * i] = data[2 * i] + inLayout->pen[0];
+	vertices[2 * i + 1] = data[2 * i + 1] + inLayout->pen[1];
+      }
+
+      /* Each contour is a line loop which is drawn as separate lines */
+      for (k = 0; k < inGlyph->nContour; k++) {
+	for (i = inGlyph->contours[k]; i < inGlyph->contours[k + 1]; i++) {
+	  *(indices++) = base + i;
+	  *(indices++) = base + ((i + 1 < inGlyph->contours[k + 1]) ?
+				 i + 1 : inGlyph->contours[k]);
+	}
+      }
+
+      __glcArenaFree(inContext->arena, data);
+      return GL_TRUE;
+    }
+  case GLC_TRIANGLE:
+    {
+      GLuint* vertexIndices = NULL;
+      GLint nVertex = 0;
+      GLint j = 0;
+      GLint cap = 0;
+      GLboolean success = GL_FALSE;
+
+      data = (GLfloat*)__glcReadBufferObject(inContext, GL_ARRAY_BUFFER_ARB,
+					     inGlyph->glObject[0], &size);
+      if (!data)
+	return GL_FALSE;
+      nVertex = size / (2 * sizeof(GLfloat));
+
+      vertexIndices = (GLuint*)__glcReadBufferObject(inContext,
+					     GL_ELEMENT_ARRAY_BUFFER_ARB,
+					     inGlyph->glObject[2], &size);
+      if (!vertexIndices) {
+	__glcArenaFree(inContext->arena, data);
+	return GL_FALSE;
+      }
+
+      /* The caps are stored once for a flat string and twice for an extruded
+       * string : at z=0 for the front cap and at z=-1 for the back cap.
+       */
+      for (cap = 0; cap < (text->extrude ? 2 : 1); cap++) {
+	GLuint* batchIndices = vertexIndices;
+
+	base = GLC_ARRAY_LENGTH(inLayout->vertices) / inLayout->stride;
+	vertices = (GLfloat*)__glcArrayInsertCell(inLayout->vertices,
+				      GLC_ARRAY_LENGTH(inLayout->vertices),
+				      inLayout->stride * nVertex);
+	if (!vertices)
+	  goto release;
+
+	for (i = 0; i < nVertex; i++) {
+	  if (text->extrude) {
+	    vertices[0] = 0.f;
+	    vertices[1] = 0.f;
+	    vertices[2] = cap ? -1.f : 1.f;
+	    vertices[5] = cap ? -1.f : 0.f;
+	    vertices += 3;
+	  }
+	  vertices[0] = data[2 * i] + inLayout->pen[0];
+	  vertices[1] = data[2 * i + 1] + inLayout->pen[1];
+	  vertices += 2;
+	  if (text->extrude)
+	    vertices++;
+	}
+
+	for (k = 0; k < inGlyph->nGeomBatch; k++) {
+	  if (!__glcAppendTriangles(inLayout->indices[cap ? 2 : 0],
+				    inGlyph->geomBatches[k].mode,
+				    batchIndices,
+				    inGlyph->geomBatches[k].length, base))
+	    goto release;
+	  batchIndices += inGlyph->geomBatches[k].length;
+	}
+      }
+
+      if (text->extrude) {
+	GLfloat* sides = NULL;
+
+	/* The sides are stored as a triangle strip per contour, each point of
+	 * the contour (the first one being repeated at the end) giving two
+	 * vertices at z=0 and z=-1.
+	 */
+	sides = (GLfloat*)__glcReadBufferObject(inContext, GL_ARRAY_BUFFER_ARB,
+						inGlyph->glObject[3], &size);
+	if (!sides)
+	  goto release;
+
+	base = GLC_ARRAY_LENGTH(inLayout->vertices) / 6;
+	nVertex = size / (6 * sizeof(GLfloat));
+	vertices = (GLfloat*)__glcArrayInsertCell(inLayout->vertices,
+				      GLC_ARRAY_LENGTH(inLayout->vertices),
+				      6 * nVertex);
+	if (!vertices) {
+	  __glcArenaFree(inContext->arena, sides);
+	  goto release;
+	}
+
+	for (i = 0; i < nVertex; i++) {
+	  memcpy(vertices, sides + 6 * i, 6 * sizeof(GLfloat));
+	  vertices[3] += inLayout->pen[0];
+	  vertices[4] += inLayout->pen[1];
+	  vertices += 6;
+	}
+
+	__glcArenaFree(inContext->arena, sides);
+
+	for (k = 0; k < inGlyph->nContour; k++) {
+	  GLint length = (inGlyph->contours[k + 1] - inGlyph->contours[k] + 1)
+	    * 2;
+
+	  if (!__glcAppendTriangles(inLayout->indices[1], GL_TRIANGLE_STRIP,
+				    NULL, length, base + j))
+	    goto release;
+	  j += length;
+	}
+      }
+
+      success = GL_TRUE;
+
+    release:
+      __glcArenaFree(inContext->arena, vertexIndices);
+      __glcArenaFree(inContext->arena, data);
+      return success;
+    }
+  }
+
+  return GL_TRUE;
+}
+
+
+
+/* This function is called by __glcProcessChar() for each character of the
+ * string of a text object. It computes the position of the glyph and appends
+ * its geometry to the layout given by 'inData'.
+ */
+static void* __glcLayoutChar(const GLint inCode, const GLint inPrevCode,
+			     const GLboolean inIsRTL,
+			     const __GLCfont* inFont,
+			     __GLCcontext* inContext, const void* inData,
+			     const GLboolean GLC_UNUSED_ARG(inMultipleChars))
+{
+  __GLCtextLayout* layout = (__GLCtextLayout*)inData;
+  __GLCglyph* glyph = NULL;
+  GLfloat advance[2] = {0.f, 0.f};
+
+  if (layout->error)
+    return NULL;
+
+#ifndef GLC_FT_CACHE
+  if (!__glcFontOpen(inFont, inContext))
+    return NULL;
+#endif
+
+  if (inPrevCode && inContext->enableState.kerning) {
+    GLfloat kerning[2];
+    GLint leftCode = inIsRTL ? inCode : inPrevCode;
+    GLint rightCode = inIsRTL ? inPrevCode : inCode;
+
+    if (__glcFontGetKerning(inFont, leftCode, rightCode, kerning, inContext,
+			    GLC_POINT_SIZE, GLC_POINT_SIZE)) {
+      layout->pen[0] += inIsRTL ? -kerning[0] : kerning[0];
+      layout->pen[1] += kerning[1];
+    }
+  }
+
+  if (__glcFontGetAdvance(inFont, inCode, advance, inContext, GLC_POINT_SIZE,
+			  GLC_POINT_SIZE))
+    glyph = __glcFontGetGlyph(inFont, inCode, inContext);
+
+#ifndef GLC_FT_CACHE
+  __glcFontClose(inFont);
+#endif
+
+  if (!glyph)
+    return NULL;
+
+  /* If the GL objects of the glyph do not exist yet, they are created by
+   * rendering the glyph once (the GL buffers are masked by the caller).
+   */
+  if (!glyph->isSpacingChar && !glyph->glObject[layout->GLObjectIndex]) {
+    GLCchar32 code = inCode;
+
+    glPushMatrix();
+    __glcRenderCountedString(inContext, &code, inIsRTL, 1, NULL);
+    glPopMatrix();
+  }
+
+  if (inIsRTL) {
+    layout->pen[0] -= advance[0];
+    layout->pen[1] += advance[1];
+  }
+
+  /* The glyph is skipped if its GL objects could not be created, as it is when
+   * glcRenderString() is called.
+   */
+  if (!glyph->isSpacingChar && glyph->glObject[layout->GLObjectIndex])
+    layout->error = !__glcLayoutGlyph(layout, inContext, glyph);
+
+  if (!inIsRTL) {
+    layout->pen[0] += advance[0];
+    layout->pen[1] += advance[1];
+  }
+
+  return NULL;
+}
+
+
+
+/* Lay out the string 'inString' of the text object 'inText' and store its
+ * geometry in a VBO and an IBO. The string must be sorted in visual order and
+ * stored using UCS4 format.
+ */
+static void __glcLayoutString(__GLCcontext* inContext, __GLCtext* inText,
+			      const GLCchar32* inString,
+			      const GLboolean inIsRightToLeft,
+			      const GLint inCount)
+{
+  __GLCtextLayout layout;
+  __GLCcharacter prevCode = {0, 0, NULL, NULL, NULL, {0.f, 0.f}};
+  GLboolean saveGLObjects = inContext->enableState.glObjects;
+  GLuint drawCallCount = GLC_STAT(inContext, GLC_DRAW_CALL_COUNT_QSO);
+  GLint vertexBufferObjectID = 0;
+  GLint elementBufferObjectID = 0;
+  const GLCchar32* ptr = inString;
+  GLint shift = 1;
+  GLint i = 0;
+
+  inText->renderStyle = inContext->renderState.renderStyle;
+  inText->extrude = (inText->renderStyle == GLC_TRIANGLE)
+    && inContext->enableState.extrude;
+  inText->resolution = inContext->renderState.resolution / 72.;
+
+  /* The atlas must be emptied if it has been filled for the other texture
+   * style (see __glcRenderCountedString()).
+   */
+  if (GLC_IS_TEXTURE_STYLE(inText->renderStyle)
+      && (inContext->atlasStyle != inText->renderStyle)) {
+    __glcTextureAtlasFlush(inContext);
+    inContext->atlasStyle = inText->renderStyle;
+  }
+
+  memset(&layout, 0, sizeof(__GLCtextLayout));
+  layout.text = inText;
+  layout.GLObjectIndex = GLC_IS_TEXTURE_STYLE(inText->renderStyle) ?
+    1 : inText->renderStyle - 0x101 + (inText->extrude ? 1 : 0);
+  layout.stride = GLC_IS_TEXTURE_STYLE(inText->renderStyle) ? 5 :
+    (inText->extrude ? 6 : 2);
+  layout.vertices = __glcArrayCreate(sizeof(GLfloat));
+  for (i = 0; i < (inText->extrude ? 3 : 1); i++)
+    layout.indices[i] = __glcArrayCreate(sizeof(GLuint));
+  if (GLC_IS_TEXTURE_STYLE(inText->renderStyle) && !inText->atlasElements)
+    inText->atlasElements = __glcArrayCreate(sizeof(__GLCatlasElement*));
+
+  if (!layout.vertices || !layout.indices[0]
+      || (inText->extrude && (!layout.indices[1] || !layout.indices[2]))
+      || (GLC_IS_TEXTURE_STYLE(inText->renderStyle)
+	  && !inText->atlasElements)) {
+    layout.error = GL_TRUE;
+    goto release;
+  }
+
+  glGetIntegerv(GL_ARRAY_BUFFER_BINDING_ARB, &vertexBufferObjectID);
+  glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING_ARB, &elementBufferObjectID);
+
+  /* The GL objects of the glyphs are used to lay out the string, whatever the
+   * value of GLC_GL_OBJECTS is. The glyphs that have no GL objects yet are
+   * rendered once to create them, with the GL buffers masked.
+   */
+  inContext->enableState.glObjects = GL_TRUE;
+  glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT
+	       | GL_STENCIL_BUFFER_BIT);
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+  glDepthMask(GL_FALSE);
+  glStencilMask(0);
+
+  if (inIsRightToLeft) {
+    ptr += inCount - 1;
+    shift = -1;
+  }
+
+  for (i = 0; (i < inCount) && !layout.error; i++) {
+    if (*ptr >= 32)
+      __glcProcessChar(inContext, *ptr, &prevCode, inIsRightToLeft,
+		       __glcLayoutChar, &layout);
+    ptr += shift;
+  }
+
+  glPopAttrib();
+  inContext->enableState.glObjects = saveGLObjects;
+
+  /* The glyphs that have been rendered to create their GL objects have not
+   * been drawn : they are not counted as draw calls.
+   */
+  GLC_STAT(inContext, GLC_DRAW_CALL_COUNT_QSO) = drawCallCount;
+
+  inText->advance[0] = layout.pen[0];
+  inText->advance[1] = layout.pen[1];
+
+  if (!layout.error && GLC_ARRAY_LENGTH(layout.indices[0])) {
+    /* The indices of the extruded strings are stored in the order front cap,
+     * sides, back cap so that a single range is drawn whatever the
+     * orientation of the string is.
+     */
+    if (inText->extrude) {
+      GLuint* indices = (GLuint*)__glcArrayInsertCell(layout.indices[0],
+				      GLC_ARRAY_LENGTH(layout.indices[0]),
+				      GLC_ARRAY_LENGTH(layout.indices[1])
+				      + GLC_ARRAY_LENGTH(layout.indices[2]));
+
+      if (!indices) {
+	layout.error = GL_TRUE;
+	goto restore;
+      }
+
+      inText->capCount = GLC_ARRAY_LENGTH(layout.indices[2]);
+      memcpy(indices, GLC_ARRAY_DATA(layout.indices[1]),
+	     GLC_ARRAY_SIZE(layout.indices[1]));
+      memcpy(indices + GLC_ARRAY_LENGTH(layout.indices[1]),
+	     GLC_ARRAY_DATA(layout.indices[2]),
+	     GLC_ARRAY_SIZE(layout.indices[2]));
+    }
+
+    glGenBuffersARB(2, inText->bufferObjectID);
+    if (!inText->bufferObjectID[0] || !inText->bufferObjectID[1]) {
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      layout.error = GL_TRUE;
+      goto restore;
+    }
+
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, inText->bufferObjectID[0]);
+    glBufferDataARB(GL_ARRAY_BUFFER_ARB, GLC_ARRAY_SIZE(layout.vertices),
+		    GLC_ARRAY_DATA(layout.vertices), GL_STATIC_DRAW_ARB);
+    glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, inText->bufferObjectID[1]);
+    glBufferDataARB(GL_ELEMENT_ARRAY_BUFFER_ARB,
+		    GLC_ARRAY_SIZE(layout.indices[0]),
+		    GLC_ARRAY_DATA(layout.indices[0]), GL_STATIC_DRAW_ARB);
+    GLC_STAT_ADD(inContext, GLC_BUFFER_UPLOAD_COUNT_QSO, 2);
+    GLC_STAT_ADD(inContext, GLC_BUFFER_UPLOAD_BYTES_QSO,
+		 GLC_ARRAY_SIZE(layout.vertices)
+		 + GLC_ARRAY_SIZE(layout.indices[0]));
+    inText->indexCount = GLC_ARRAY_LENGTH(layout.indices[0]);
+  }
+
+ restore:
+  glBindBufferARB(GL_ARRAY_BUFFER_ARB, vertexBufferObjectID);
+  glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, elementBufferObjectID);
+
+ release:
+  if (layout.vertices)
+    __glcArrayDestroy(layout.vertices);
+  for (i = 0; i < 3; i++) {
+    if (layout.indices[i])
+      __glcArrayDestroy(layout.indices[i]);
+  }
+
+  /* The text object is left empty if the layout has failed */
+  if (layout.error)
+    __glcTextDestroyGLObjects(inText, inContext);
+}
+
+
+
+/** \ingroup render
+ *  This command lays out the string \e inString and stores the result in the
+ *  text object identified by \e inText. The string is rendered with the
+ *  values that the GLC state variables have when the command is issued : the
+ *  current font list, the rendering style, the resolution, the kerning and
+ *  the string type. The result replaces the previous content of the text
+ *  object, if any. If \e inString is NULL, the text object becomes empty.
+ *
+ *  The geometry of the whole string is stored in a vertex buffer object and
+ *  an index buffer object so that glcDrawTextQSO() draws it with a single
+ *  call to \c glDrawElements. The geometry is copied from the GL objects of
+ *  the glyphs (see glcEnable() with argument \b GLC_GL_OBJECTS) which are
+ *  created if needed, whatever the value of \b GLC_GL_OBJECTS is. With the
+ *  rendering styles \b GLC_TEXTURE and \b GLC_SDF_QSO, the vertices refer to
+ *  the glyphs stored in the texture atlas : their areas are kept in the atlas
+ *  until the text object is emptied or deleted.
+ *
+ *  If the GL implementation does not support the extension
+ *  \c GL_ARB_vertex_buffer_object, and with the rendering styles
+ *  \b GLC_BITMAP and \b GLC_PIXMAP_QSO, the string is stored as a GL display
+ *  list instead. The display list does not depend on the GL objects of the
+ *  glyphs so, with the texture styles, it stores the image of every glyph
+ *  and uploads it to the texture each time glcDrawTextQSO() is called. Those
+ *  uploads are counted by \b GLC_TEXTURE_UPLOAD_COUNT_QSO and
+ *  \b GLC_TEXTURE_UPLOAD_BYTES_QSO when the text object is drawn.
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inText has not been
+ *  generated by glcGenTextQSO(). It raises \b GLC_STATE_ERROR if a GL display
+ *  list is being built when the command is issued and
+ *  \b GLC_RESOURCE_ERROR if GL can not allocate the buffer objects or the
+ *  display list.
+ *  \param inText The ID of the text object
+ *  \param inString A zero-terminated string of characters.
+ *  \sa glcGenTextQSO()
+ *  \sa glcDrawTextQSO()
+ *  \sa glcRenderString()
+ */
+void APIENTRY glcTextStringQSO(GLint inText, const GLCchar* inString)
+{
+  __GLCcontext *ctx = NULL;
+  __GLCtext* text = NULL;
+  GLCchar32* UinString = NULL;
+  GLboolean isRightToLeft = GL_FALSE;
+  GLint length = 0;
+  GLint listIndex = 0;
+  GLuint drawCallCount = 0;
+  GLuint bufferUploadCount = 0;
+  GLuint bufferUploadBytes = 0;
+  GLuint textureUploadCount = 0;
+  GLuint textureUploadBytes = 0;
+
+  GLC_INIT_THREAD();
+
+  /* Verify that the thread has a current context and that the text object
+   * identified by 'inText' exists.
+   */
+  text = __glcVerifyTextParameters(inText);
+  if (!text)
+    return;
+
+  ctx = GLC_GET_CURRENT_CONTEXT();
+
+  /* GL display lists can not be nested */
+  glGetIntegerv(GL_LIST_INDEX, &listIndex);
+  if (listIndex) {
+    __glcRaiseError(GLC_STATE_ERROR);
+    return;
+  }
+
+  if (!inString) {
+    __glcTextDestroyGLObjects(text, ctx);
+    return;
+  }
+
+  /* Creates a Unicode string based on the current string type. Basically,
+   * that means that inString is read in the current string format.
+   */
+  UinString = __glcConvertToVisualUcs4(ctx, &isRightToLeft, &length, inString,
+				       NULL);
+  if (!UinString)
+    return;
+
+  __glcTextDestroyGLObjects(text, ctx);
+
+  if (GLEW_ARB_vertex_buffer_object
+      && (ctx->renderState.renderStyle != GLC_BITMAP)
+      && (ctx->renderState.renderStyle != GLC_PIXMAP_QSO)) {
+    __glcLayoutString(ctx, text, UinString, isRightToLeft, length);
+    return;
+  }
+
+  if (!text->displayList) {
+    text->displayList = glGenLists(1);
+    if (!text->displayList) {
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      return;
+    }
+  }
+
+  /* While the display list is compiled, __glcRenderCountedString() does not
+   * use the GL objects of the glyphs : the display list does not depend on
+   * them.
+   */
+  drawCallCount = GLC_STAT(ctx, GLC_DRAW_CALL_COUNT_QSO);
+  bufferUploadCount = GLC_STAT(ctx, GLC_BUFFER_UPLOAD_COUNT_QSO);
+  bufferUploadBytes = GLC_STAT(ctx, GLC_BUFFER_UPLOAD_BYTES_QSO);
+  textureUploadCount = GLC_STAT(ctx, GLC_TEXTURE_UPLOAD_COUNT_QSO);
+  textureUploadBytes = GLC_STAT(ctx, GLC_TEXTURE_UPLOAD_BYTES_QSO);
+  glNewList(text->displayList, GL_COMPILE);
+  __glcRenderCountedString(ctx, UinString, isRightToLeft, length, NULL);
+  glEndList();
+
+  /* The GL commands that have been compiled in the display list have not been
+   * executed yet : they are not counted as draw calls nor as uploads. The
+   * texture uploads are counted instead each time the display list is called
+   * by glcDrawTextQSO(). The glyphs loaded, the tesselations and the lookups
+   * in the caches have actually been performed so their counters are kept.
+   */
+  text->uploadCount = GLC_STAT(ctx, GLC_TEXTURE_UPLOAD_COUNT_QSO)
+    - textureUploadCount;
+  text->uploadBytes = GLC_STAT(ctx, GLC_TEXTURE_UPLOAD_BYTES_QSO)
+    - textureUploadBytes;
+  GLC_STAT(ctx, GLC_DRAW_CALL_COUNT_QSO) = drawCallCount;
+  GLC_STAT(ctx, GLC_BUFFER_UPLOAD_COUNT_QSO) = bufferUploadCount;
+  GLC_STAT(ctx, GLC_BUFFER_UPLOAD_BYTES_QSO) = bufferUploadBytes;
+  GLC_STAT(ctx, GLC_TEXTURE_UPLOAD_COUNT_QSO) = textureUploadCount;
+  GLC_STAT(ctx, GLC_TEXTURE_UPLOAD_BYTES_QSO) = textureUploadBytes;
+}
+
+
+
+/** \ingroup render
+ *  This command draws the string stored in the text object identified by
+ *  \e inText. Like glcRenderString(), the GL modelview matrix is translated
+ *  by the advance of the string. Nothing is drawn if the text object is
+ *  empty. The string is drawn with the rendering style and the resolution
+ *  that were current when glcTextStringQSO() was issued, and the GL state
+ *  that the command modifies is restored before it returns.
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inText has not been
+ *  generated by glcGenTextQSO().
+ *  \param inText The ID of the text object
+ *  \sa glcGenTextQSO()
+ *  \sa glcTextStringQSO()
+ */
+void APIENTRY glcDrawTextQSO(GLint inText)
+{
+  __GLCcontext *ctx = NULL;
+  __GLCtext* text = NULL;
+
+  GLC_INIT_THREAD();
+
+  text = __glcVerifyTextParameters(inText);
+  if (!text)
+    return;
+
+  ctx = GLC_GET_CURRENT_CONTEXT();
+
+  if (text->displayList) {
+    glCallList(text->displayList);
+    GLC_STAT_INC(ctx, GLC_DRAW_CALL_COUNT_QSO);
+    GLC_STAT_ADD(ctx, GLC_TEXTURE_UPLOAD_COUNT_QSO, text->uploadCount);
+    GLC_STAT_ADD(ctx, GLC_TEXTURE_UPLOAD_BYTES_QSO, text->uploadBytes);
+    return;
+  }
+
+  if (!text->renderStyle)
+    return;
+
+  glScalef(text->resolution, text->resolution, 1.f);
+
+  if (text->indexCount) {
+    GLuint* indices = NULL;
+    GLsizei count = text->indexCount - text->capCount;
+    GLint program = 0;
+
+    /* The GL state that is modified below is restored at once by GL */
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_TEXTURE_BIT);
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    glBindBufferARB(GL_ARRAY_BUFFER_ARB, text->bufferObjectID[0]);
+    glBindBufferARB(GL_ELEMENT_ARRAY_BUFFER_ARB, text->bufferObjectID[1]);
+    glNormal3f(0.f, 0.f, 1.f / text->resolution);
+
+    if (GLC_IS_TEXTURE_STYLE(text->renderStyle)) {
+      glInterleavedArrays(GL_T2F_V3F, 0, NULL);
+      glBindTexture(GL_TEXTURE_2D, ctx->atlas.id);
+      glEnable(GL_BLEND);
+      glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+      glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+      if (text->renderStyle == GLC_SDF_QSO) {
+	if (GLEW_ARB_fragment_program)
+	  glGetProgramivARB(GL_FRAGMENT_PROGRAM_ARB, GL_PROGRAM_BINDING_ARB,
+			    &program);
+	__glcTextureEnableSdf(ctx, GL_TRUE);
+      }
+    }
+    else if (text->extrude) {
+      GLfloat modelviewMatrix[16];
+      GLfloat projectionMatrix[16];
+
+      glInterleavedArrays(GL_N3F_V3F, 0, NULL);
+      glEnable(GL_NORMALIZE);
+
+      /* Only the cap which faces the viewer is drawn, with the sides : the
+       * back cap follows the sides in the IBO.
+       */
+      glGetFloatv(GL_MODELVIEW_MATRIX, modelviewMatrix);
+      glGetFloatv(GL_PROJECTION_MATRIX, projectionMatrix);
+      if (modelviewMatrix[8] * projectionMatrix[3]
+	  + modelviewMatrix[9] * projectionMatrix[7]
+	  + modelviewMatrix[10] * projectionMatrix[11]
+	  + modelviewMatrix[11] * projectionMatrix[15] >= 0.f)
+	indices += text->capCount;
+    }
+    else
+      glInterleavedArrays(GL_V2F, 0, NULL);
+
+    glDrawElements(text->renderStyle == GLC_LINE ? GL_LINES : GL_TRIANGLES,
+		   count, GL_UNSIGNED_INT, indices);
+    GLC_STAT_INC(ctx, GLC_DRAW_CALL_COUNT_QSO);
+
+    /* The normal array leaves the current normal undefined */
+    if (text->extrude)
+      glNormal3f(0.f, 0.f, 1.f / text->resolution);
+    if ((text->renderStyle == GLC_SDF_QSO) && GLEW_ARB_fragment_program)
+      glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, program);
+
+    glPopClientAttrib();
+    glPopAttrib();
+  }
+
+  glTranslatef(text->advance[0], text->advance[1], 0.f);
+  glScalef(1.f / text->resolution, 1.f / text->resolution, 1.f);
+}
+
+
+
+/** \ingroup render
+ *  This command deletes the text object identified by \e inText and releases
+ *  its GL objects. The ID \e inText becomes unused.
+ *
+ *  The command raises \b GLC_PARAMETER_ERROR if \e inText has not been
+ *  generated by glcGenTextQSO().
+ *  \param inText The ID of the text object to delete
+ *  \sa glcGenTextQSO()
+ */
+void APIENTRY glcDeleteTextQSO(GLint inText)
+{
+  __GLCcontext *ctx = NULL;
+  __GLCtext* text = NULL;
+
+  GLC_INIT_THREAD();
+
+  text = __glcVerifyTextParameters(inText);
+  if (!text)
+    return;
+
+  ctx = GLC_GET_CURRENT_CONTEXT();
+
+  FT_List_Remove(&ctx->textList, &text->node);
+  __glcTextDestroy(text, ctx);
+}
@@ -29,9 +29,27 @@
 #else
 #include <GL/glu.h>
 #endif
+#include <math.h>
 
 #include "texture.h"
 
+/* The channels of the multi-channel distance field. The edges of the contours
+ * are colored with the combinations of two channels so that the edges which
+ * meet at a corner share exactly one channel.
+ */
+#define GLC_MSDF_RED		1
+#define GLC_MSDF_GREEN		2
+#define GLC_MSDF_BLUE		4
+#define GLC_MSDF_YELLOW		(GLC_MSDF_RED | GLC_MSDF_GREEN)
+#define GLC_MSDF_MAGENTA	(GLC_MSDF_RED | GLC_MSDF_BLUE)
+#define GLC_MSDF_CYAN		(GLC_MSDF_GREEN | GLC_MSDF_BLUE)
+#define GLC_MSDF_WHITE		(GLC_MSDF_RED | GLC_MSDF_GREEN | GLC_MSDF_BLUE)
+/* The segment is the first (resp. the last) one of an edge */
+#define GLC_MSDF_EDGE_START	8
+#define GLC_MSDF_EDGE_END	16
+/* Cosine of the smallest deviation of the outline that is a corner */
+#define GLC_MSDF_CORNER_COS	.8f
+
 
 
 /* This function is called when a glyph is destroyed, the atlas element is then
@@ -52,6 +70,636 @@ void __glcReleaseAtlasElement(__GLCatlasElement* This,
 
 
 
+/* This function is called when a text object stores the quad of the atlas
+ * element 'This' in its vertex buffer : the area of the element must not be
+ * given to another glyph as long as the text object uses it.
+ */
+void __glcPinAtlasElement(__GLCatlasElement* This, __GLCcontext* inContext)
+{
+  This->pinCount++;
+  inContext->atlasPinCount++;
+}
+
+
+
+/* This function is called when a text object no longer uses the atlas element
+ * 'This'. If no glyph owns the element anymore, it is put at the tail of the
+ * list so that its position is used as soon as possible.
+ */
+void __glcUnpinAtlasElement(__GLCatlasElement* This, __GLCcontext* inContext)
+{
+  assert(This->pinCount > 0);
+
+  This->pinCount--;
+  inContext->atlasPinCount--;
+
+  if (!This->pinCount && !This->glyph) {
+    FT_List_Remove(&inContext->atlasList, (FT_ListNode)This);
+    FT_List_Add(&inContext->atlasList, (FT_ListNode)This);
+  }
+}
+
+
+
+/* This function releases all the areas of the texture atlas. The glyphs which
+ * were stored in the atlas lose their texture and the atlas is ready to be
+ * filled again from scratch.
+ */
+void __glcTextureAtlasFlush(__GLCcontext* inContext)
+{
+  FT_ListNode node = NULL;
+
+  for (node = inContext->atlasList.head; node; node = node->next) {
+    __GLCatlasElement* atlasNode = (__GLCatlasElement*)node;
+
+    if (atlasNode->glyph) {
+      __glcGlyphDestroyTexture(atlasNode->glyph, inContext);
+      atlasNode->glyph = NULL;
+    }
+  }
+
+  /* The areas that are pinned by the text objects must keep their position in
+   * the atlas : the elements are kept in the list, free of any glyph, and they
+   * will be reused by the eviction when they are no longer pinned.
+   */
+  if (inContext->atlasPinCount)
+    return;
+
+  /* All the elements of the atlas are released at once */
+  inContext->atlasList.head = NULL;
+  inContext->atlasList.tail = NULL;
+  __glcPoolReset(inContext->atlasPool);
+  inContext->atlasCount = 0;
+}
+
+
+
+static int __glcTextureCompareCrossings(const void* inCrossing1,
+					const void* inCrossing2)
+{
+  const GLfloat crossing1 = *(const GLfloat*)inCrossing1;
+  const GLfloat crossing2 = *(const GLfloat*)inCrossing2;
+
+  if (crossing1 < crossing2)
+    return -1;
+  return (crossing1 > crossing2) ? 1 : 0;
+}
+
+
+
+/* Give a color to the segments of the contour which goes from the vertex
+ * 'inFirst' to the vertex 'inLast' - 1. The contours are flattened so the
+ * corners are the vertices where the direction of the outline deviates by more
+ * than acos(GLC_MSDF_CORNER_COS) : the segments between two corners make an
+ * edge and every edge gets a color different from the colors of its
+ * neighbours. A contour without corner is white (its field is the same in the
+ * 3 channels) and a contour with a single corner is split in 3 edges. The
+ * segments of null length get no color. 'outSegments' is a scratch buffer of
+ * 'inLast' - 'inFirst' indices.
+ */
+static void __glcTextureColorContour(GLubyte* outColors, GLint* outSegments,
+				     GLfloat (*inVertexArray)[2],
+				     const GLint inFirst, const GLint inLast)
+{
+  const GLubyte nextColor[8] = {0, 0, 0, GLC_MSDF_CYAN, 0, GLC_MSDF_YELLOW,
+				GLC_MSDF_MAGENTA, 0};
+  GLint nSegment = 0;
+  GLint nCorner = 0;
+  GLint firstCorner = 0;
+  GLubyte color = GLC_MSDF_CYAN;
+  GLint i = 0, j = 0;
+
+  for (j = inFirst; j < inLast; j++) {
+    GLfloat* a = inVertexArray[j];
+    GLfloat* b = inVertexArray[(j + 1 < inLast) ? j + 1 : inFirst];
+
+    outColors[j] = 0;
+    if ((a[0] != b[0]) || (a[1] != b[1]))
+      outSegments[nSegment++] = j;
+  }
+
+  /* Look for the corners : the deviation between a segment and the previous
+   * one is compared to the threshold.
+   */
+  for (i = 0; i < nSegment; i++) {
+    GLint current = outSegments[i];
+    GLint previous = outSegments[i ? i - 1 : nSegment - 1];
+    GLfloat* a = inVertexArray[previous];
+    GLfloat* b = inVertexArray[current];
+    GLfloat* c = inVertexArray[(current + 1 < inLast) ? current + 1 : inFirst];
+    const GLfloat abx = b[0] - a[0];
+    const GLfloat aby = b[1] - a[1];
+    const GLfloat bcx = c[0] - b[0];
+    const GLfloat bcy = c[1] - b[1];
+
+    if ((abx * bcx + aby * bcy) < GLC_MSDF_CORNER_COS
+	* sqrt((abx * abx + aby * aby) * (bcx * bcx + bcy * bcy))) {
+      outColors[current] |= GLC_MSDF_EDGE_START;
+      outColors[previous] |= GLC_MSDF_EDGE_END;
+      if (!nCorner++)
+	firstCorner = i;
+    }
+  }
+
+  if (!nCorner || ((nCorner == 1) && (nSegment < 3))) {
+    for (i = 0; i < nSegment; i++)
+      outColors[outSegments[i]] = GLC_MSDF_WHITE;
+    return;
+  }
+
+  /* Walk along the contour from its first corner */
+  for (i = 0, j = 0; i < nSegment; i++) {
+    GLint segment = outSegments[(firstCorner + i) % nSegment];
+
+    if (nCorner == 1) {
+      /* Split the contour in 3 edges : the corner is between the first one and
+       * the last one which share the red channel.
+       */
+      if (3 * i < nSegment)
+	color = GLC_MSDF_MAGENTA;
+      else if (3 * i < 2 * nSegment)
+	color = GLC_MSDF_WHITE;
+      else
+	color = GLC_MSDF_YELLOW;
+    }
+    else if (i && (outColors[segment] & GLC_MSDF_EDGE_START)) {
+      color = nextColor[color];
+      /* The last edge must also differ from the first one */
+      if ((++j == nCorner - 1) && (color == GLC_MSDF_CYAN))
+	color = nextColor[color];
+    }
+
+    outColors[segment] |= color;
+  }
+}
+
+
+
+/* Check if the interpolation of the multi-channel distance field between the
+ * texels 'inTexel1' and 'inTexel2' can create an artifact : two channels
+ * cross the outline between them while they differ by more than 'inThreshold'.
+ * Only the texel which is the farthest from the outline is reported.
+ */
+static GLboolean __glcTextureDetectClash(const GLfloat* inTexel1,
+					 const GLfloat* inTexel2,
+					 const GLfloat inThreshold)
+{
+  GLfloat a[3], b[3], delta[3];
+  GLint i = 0, j = 0;
+
+  for (i = 0; i < 3; i++) {
+    a[i] = inTexel1[i];
+    b[i] = inTexel2[i];
+    delta[i] = fabsf(b[i] - a[i]);
+  }
+
+  /* Sort the channels by decreasing differences */
+  for (i = 0; i < 2; i++) {
+    for (j = 2; j > i; j--) {
+      if (delta[j] > delta[j - 1]) {
+	GLfloat tmp = delta[j];
+
+	delta[j] = delta[j - 1];
+	delta[j - 1] = tmp;
+	tmp = a[j];
+	a[j] = a[j - 1];
+	a[j - 1] = tmp;
+	tmp = b[j];
+	b[j] = b[j - 1];
+	b[j - 1] = tmp;
+      }
+    }
+  }
+
+  return (delta[1] >= inThreshold) && !((b[0] == b[1]) && (b[0] == b[2]))
+    && (fabsf(a[2] - .5f) >= fabsf(b[2] - .5f));
+}
+
+
+
+static inline GLfloat __glcTextureMedian(const GLfloat* inTexel)
+{
+  const GLfloat lower = (inTexel[0] < inTexel[1]) ? inTexel[0] : inTexel[1];
+  const GLfloat upper = (inTexel[0] < inTexel[1]) ? inTexel[1] : inTexel[0];
+
+  if (inTexel[2] < lower)
+    return lower;
+  return (inTexel[2] > upper) ? upper : inTexel[2];
+}
+
+
+
+/* Compute the signed distance field of a glyph from its contours. The
+ * contours are stored in 'inData' in the space of the bitmap 'outBuffer' with
+ * 64 units per pixel (see __glcFaceDescGetBitmapContours()). For each pixel,
+ * the distance from its center to the nearest segment of the contours is
+ * computed and its sign is given by the odd winding rule (that is the parity
+ * of the number of segments crossed by an horizontal ray). The distances are
+ * measured on the outline itself rather than on a rasterized image of the
+ * glyph, so they are exact up to the flattening tolerance.
+ * A single channel field rounds the corners of the glyph when it is magnified.
+ * If 'inRGBA' is GL_TRUE, 'outBuffer' is an RGBA image whose alpha channel
+ * stores the field above while the RGB channels store a multi-channel distance
+ * field : the edges of the contours are colored (see
+ * __glcTextureColorContour()) and each channel stores the signed distance to
+ * the nearest edge of its color. Beyond the ends of an edge, the distance to
+ * the line which extends the edge is used instead so that the median of the 3
+ * channels has a sharp corner where two edges meet. The sign of the 3 channels
+ * is then fixed where their median disagrees with the odd winding rule, and
+ * the texels whose interpolation with a neighbour would create an artifact are
+ * replaced by their median.
+ * The distances are mapped to [0, 255] so that the outline is stored at the
+ * iso-value 127.5 and the distances larger than 'inSpread' pixels are clamped.
+ * Hence a segment only needs to be compared with the pixels that are closer
+ * than 'inSpread' pixels to its bounding box, and the sign is computed row by
+ * row from the sorted abscissae where the contours cross the row.
+ * The function returns GL_FALSE if the temporary buffers can not be allocated
+ * in the arena 'inArena'.
+ */
+static GLboolean __glcTextureComputeDistanceField(GLubyte* outBuffer,
+						  const GLint inWidth,
+						  const GLint inHeight,
+						  const GLfloat inSpread,
+						  const __GLCrendererData* inData,
+						  __GLCarena* inArena,
+						  const GLboolean inRGBA)
+{
+  GLfloat (*vertexArray)[2] =
+    (GLfloat(*)[2])GLC_ARRAY_DATA(inData->vertexArray);
+  GLint* endContour = (GLint*)GLC_ARRAY_DATA(inData->endContour);
+  const GLint nContour = GLC_ARRAY_LENGTH(inData->endContour) - 1;
+  const GLint nVertex = (nContour > 0) ? endContour[nContour] : 0;
+  const GLint nPixel = inWidth * inHeight;
+  const GLfloat spread = 64.f * inSpread;
+  GLfloat* field = NULL;
+  GLfloat* crossings = NULL;
+  /* For each pixel and each channel of the multi-channel field : the squared
+   * distance to the nearest segment, how orthogonal the segment is to the
+   * pixel and the signed distance to the segment or to its extension.
+   */
+  GLfloat (*channels)[3][3] = NULL;
+  GLubyte* colors = NULL;
+  GLfloat orientation = 0.f;
+  GLint x = 0, y = 0, i = 0, j = 0, k = 0;
+
+  field = (GLfloat*)__glcArenaAlloc(inArena,
+				    (nPixel + nVertex) * sizeof(GLfloat)
+				    + (inRGBA ?
+				       nPixel * 9 * sizeof(GLfloat)
+				       + nVertex * (sizeof(GLint) + 1) : 0));
+  if (!field)
+    return GL_FALSE;
+  crossings = field + nPixel;
+
+  for (i = 0; i < nPixel; i++)
+    field[i] = spread * spread;
+
+  if (inRGBA) {
+    channels = (GLfloat(*)[3][3])(crossings + nVertex);
+    colors = (GLubyte*)((GLint*)(channels + nPixel) + nVertex);
+
+    for (i = 0; i < nPixel; i++) {
+      for (k = 0; k < 3; k++) {
+	channels[i][k][0] = spread * spread;
+	channels[i][k][1] = -1.f; /* No segment yet */
+      }
+    }
+
+    /* The signed distances to the segments are positive on their left. The
+     * sign of the area of the outline tells if it is the inside of the glyph.
+     */
+    for (i = 0; i < nContour; i++) {
+      __glcTextureColorContour(colors, (GLint*)(channels + nPixel),
+			       vertexArray, endContour[i], endContour[i + 1]);
+      for (j = endContour[i]; j < endContour[i + 1]; j++) {
+	GLfloat* a = vertexArray[j];
+	GLfloat* b = vertexArray[(j + 1 < endContour[i + 1]) ?
+				 j + 1 : endContour[i]];
+
+	orientation += a[0] * b[1] - a[1] * b[0];
+      }
+    }
+    orientation = (orientation < 0.f) ? -1.f : 1.f;
+  }
+
+  /* Compute the squared distance from the center of the pixels to the
+   * segments. Only the pixels that are less than 'spread' away from the
+   * bounding box of a segment are visited.
+   */
+  for (i = 0; i < nContour; i++) {
+    for (j = endContour[i]; j < endContour[i + 1]; j++) {
+      GLfloat* a = vertexArray[j];
+      GLfloat* b = vertexArray[(j + 1 < endContour[i + 1]) ?
+			       j + 1 : endContour[i]];
+      const GLfloat abx = b[0] - a[0];
+      const GLfloat aby = b[1] - a[1];
+      const GLfloat length = abx * abx + aby * aby;
+      const GLfloat norm = sqrt(length);
+      const GLubyte color = colors ? colors[j] : 0;
+      GLint xmin = (GLint)ceil(((a[0] < b[0] ? a[0] : b[0]) - spread - 32.f)
+			       / 64.f);
+      GLint xmax = (GLint)floor(((a[0] > b[0] ? a[0] : b[0]) + spread - 32.f)
+				/ 64.f);
+      GLint ymin = (GLint)ceil(((a[1] < b[1] ? a[1] : b[1]) - spread - 32.f)
+			       / 64.f);
+      GLint ymax = (GLint)floor(((a[1] > b[1] ? a[1] : b[1]) + spread - 32.f)
+				/ 64.f);
+
+      if (xmin < 0)
+	xmin = 0;
+      if (xmax > inWidth - 1)
+	xmax = inWidth - 1;
+      if (ymin < 0)
+	ymin = 0;
+      if (ymax > inHeight - 1)
+	ymax = inHeight - 1;
+
+      for (y = ymin; y <= ymax; y++) {
+	const GLfloat apy = 64.f * y + 32.f - a[1];
+	GLfloat* distances = field + y * inWidth;
+
+	for (x = xmin; x <= xmax; x++) {
+	  GLfloat apx = 64.f * x + 32.f - a[0];
+	  GLfloat dy = apy;
+	  GLfloat t = 0.f;
+	  GLfloat tc = 0.f;
+	  GLfloat distance = 0.f;
+
+	  if (length > 0.f) {
+	    t = (apx * abx + apy * aby) / length;
+	    tc = (t < 0.f) ? 0.f : ((t > 1.f) ? 1.f : t);
+	  }
+	  apx -= tc * abx;
+	  dy -= tc * aby;
+	  distance = apx * apx + dy * dy;
+
+	  if (distance < distances[x])
+	    distances[x] = distance;
+
+	  if (color & GLC_MSDF_WHITE) {
+	    GLfloat (*texel)[3] = channels[y * inWidth + x];
+	    GLfloat ortho = 1.f;
+	    GLfloat value = 0.f;
+	    GLfloat cross = 0.f;
+	    GLboolean computed = GL_FALSE;
+
+	    for (k = 0; k < 3; k++) {
+	      if (!(color & (1 << k)) || (distance > texel[k][0]))
+		continue;
+
+	      if (!computed) {
+		cross = abx * apy - aby * (64.f * x + 32.f - a[0]);
+		value = sqrt(distance);
+		/* At the ends of the segment, a segment which is orthogonal to
+		 * the direction of the pixel is preferred.
+		 */
+		if ((tc != t) && (value > 0.f))
+		  ortho = fabsf(abx * dy - aby * apx) / (norm * value);
+		if (cross < 0.f)
+		  value = -value;
+		/* Distance to the line which extends the edge */
+		if (((t < 0.f) && (color & GLC_MSDF_EDGE_START))
+		    || ((t > 1.f) && (color & GLC_MSDF_EDGE_END))) {
+		  GLfloat pseudo = cross / norm;
+
+		  if (fabsf(pseudo) <= fabsf(value))
+		    value = pseudo;
+		}
+		computed = GL_TRUE;
+	      }
+
+	      if ((distance < texel[k][0]) || (ortho > texel[k][1])) {
+		texel[k][0] = distance;
+		texel[k][1] = ortho;
+		texel[k][2] = value;
+	      }
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+  for (y = 0; y < inHeight; y++) {
+    const GLfloat py = 64.f * y + 32.f;
+    GLint nCrossing = 0;
+    GLint crossing = 0;
+
+    /* Collect the abscissae where the contours cross the row */
+    for (i = 0; i < nContour; i++) {
+      for (j = endContour[i]; j < endContour[i + 1]; j++) {
+	GLfloat* a = vertexArray[j];
+	GLfloat* b = vertexArray[(j + 1 < endContour[i + 1]) ?
+				 j + 1 : endContour[i]];
+
+	if ((a[1] > py) != (b[1] > py))
+	  crossings[nCrossing++] = a[0] + (py - a[1]) * (b[0] - a[0])
+	    / (b[1] - a[1]);
+      }
+    }
+
+    qsort(crossings, nCrossing, sizeof(GLfloat),
+	  __glcTextureCompareCrossings);
+
+    for (x = 0; x < inWidth; x++) {
+      const GLfloat px = 64.f * x + 32.f;
+      GLfloat distance = 0.f;
+      GLfloat value = 0.f;
+
+      /* The pixel is inside the glyph if the horizontal ray that goes from
+       * its center to the right crosses an odd number of segments.
+       */
+      while ((crossing < nCrossing) && (crossings[crossing] <= px))
+	crossing++;
+
+      distance = sqrt(field[y * inWidth + x]);
+      if (!((nCrossing - crossing) & 1))
+	distance = -distance;
+
+      value = 127.5f * (1.f + distance / spread);
+      if (value < 0.f)
+	value = 0.f;
+      if (value > 255.f)
+	value = 255.f;
+
+      if (inRGBA) {
+	GLfloat (*texel)[3] = channels[y * inWidth + x];
+
+	/* Normalize the channels to [0, 1] in the first slot of the texel. The
+	 * channels that are not close to any edge of their color get the sign
+	 * of the pixel.
+	 */
+	for (k = 0; k < 3; k++) {
+	  GLfloat channel = (texel[k][1] < 0.f) ? ((distance < 0.f) ?
+						    -spread : spread)
+	    : orientation * texel[k][2];
+
+	  channel = .5f * (1.f + channel / spread);
+	  texel[0][k] = (channel < 0.f) ? 0.f : ((channel > 1.f) ? 1.f
+						  : channel);
+	}
+
+	if ((__glcTextureMedian(texel[0]) < .5f) != (distance < 0.f)) {
+	  for (k = 0; k < 3; k++)
+	    texel[0][k] = 1.f - texel[0][k];
+	}
+
+	outBuffer[4 * (y * inWidth + x) + 3] = (GLubyte)value;
+      }
+      else
+	outBuffer[y * inWidth + x] = (GLubyte)value;
+    }
+  }
+
+  if (inRGBA) {
+    /* The threshold is the difference between 2 neighbour pixels of a
+     * distance field whose gradient is 1.
+     */
+    const GLfloat threshold = 1.001f / (2.f * inSpread);
+
+    /* 'field' is reused to flag the clashes */
+    for (y = 0; y < inHeight; y++) {
+      for (x = 0; x < inWidth; x++) {
+	const GLfloat* texel = channels[y * inWidth + x][0];
+
+	field[y * inWidth + x] =
+	  ((x > 0) && __glcTextureDetectClash(texel, texel - 9, threshold))
+	  || ((x < inWidth - 1)
+	      && __glcTextureDetectClash(texel, texel + 9, threshold))
+	  || ((y > 0) && __glcTextureDetectClash(texel, texel - 9 * inWidth,
+						  threshold))
+	  || ((y < inHeight - 1)
+	      && __glcTextureDetectClash(texel, texel + 9 * inWidth,
+					 threshold));
+      }
+    }
+
+    for (i = 0; i < nPixel; i++) {
+      GLfloat* texel = channels[i][0];
+
+      if (field[i] != 0.f) {
+	const GLfloat median = __glcTextureMedian(texel);
+
+	texel[0] = median;
+	texel[1] = median;
+	texel[2] = median;
+      }
+
+      for (k = 0; k < 3; k++)
+	outBuffer[4 * i + k] = (GLubyte)(255.f * texel[k]);
+    }
+  }
+
+  __glcArenaFree(inArena, field);
+  return GL_TRUE;
+}
+
+
+
+/* The fragment program of GLC_SDF_QSO : the outline of the glyph is located
+ * where the median of the 3 channels of the multi-channel distance field is
+ * 0.5. The fragments outside the outline are discarded and the others get the
+ * current color.
+ */
+static const char __glcSdfProgram[] =
+  "!!ARBfp1.0\n"
+  "TEMP texel, median;\n"
+  "TEX texel, fragment.texcoord[0], texture[0], 2D;\n"
+  "MIN median.x, texel.x, texel.y;\n"
+  "MAX median.y, texel.x, texel.y;\n"
+  "MIN median.y, median.y, texel.z;\n"
+  "MAX median.x, median.x, median.y;\n"
+  "SUB median.x, median.x, 0.5;\n"
+  "KIL median.x;\n"
+  "MOV result.color, fragment.color;\n"
+  "END\n";
+
+
+
+/* Return the fragment program of GLC_SDF_QSO, it is created if it does not
+ * exist yet. The program is left bound to GL_FRAGMENT_PROGRAM_ARB. The
+ * function returns 0 if the GL implementation does not support fragment
+ * programs or if the program can not be created.
+ */
+static GLuint __glcTextureGetSdfProgram(__GLCcontext* inContext)
+{
+  GLint errorPosition = 0;
+
+  if (!GLEW_ARB_fragment_program)
+    return 0;
+
+  if (inContext->sdfProgramID) {
+    glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, inContext->sdfProgramID);
+    return inContext->sdfProgramID;
+  }
+
+  glGenProgramsARB(1, &inContext->sdfProgramID);
+  if (!inContext->sdfProgramID)
+    return 0;
+
+  glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, inContext->sdfProgramID);
+  glProgramStringARB(GL_FRAGMENT_PROGRAM_ARB, GL_PROGRAM_FORMAT_ASCII_ARB,
+		     sizeof(__glcSdfProgram) - 1, __glcSdfProgram);
+  glGetIntegerv(GL_PROGRAM_ERROR_POSITION_ARB, &errorPosition);
+  if (errorPosition != -1) {
+    glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, 0);
+    glDeleteProgramsARB(1, &inContext->sdfProgramID);
+    inContext->sdfProgramID = 0;
+  }
+
+  return inContext->sdfProgramID;
+}
+
+
+
+/* Return the internal format of the textures for the current rendering style.
+ * The glyphs of GLC_SDF_QSO are stored in RGBA textures whose RGB channels
+ * store the multi-channel distance field, provided that the fragment program
+ * which decodes it can be used.
+ */
+static GLint __glcTextureGetFormat(__GLCcontext* inContext)
+{
+  if ((inContext->renderState.renderStyle == GLC_SDF_QSO)
+      && __glcTextureGetSdfProgram(inContext))
+    return GL_RGBA8;
+
+  return GL_ALPHA8;
+}
+
+
+
+/* Set the GL state that draws the GLC_SDF_QSO glyphs which are stored in the
+ * texture atlas if 'inAtlas' is GL_TRUE, or in the texture for immediate mode
+ * otherwise. The multi-channel distance fields are drawn by the fragment
+ * program of GLC_SDF_QSO while the alpha test cuts the single channel fields
+ * along their 0.5 iso-value. The function returns GL_TRUE if the fragment
+ * program is enabled : its binding is not saved by glPushAttrib().
+ */
+GLboolean __glcTextureEnableSdf(__GLCcontext* inContext,
+				const GLboolean inAtlas)
+{
+  GLint format = 0;
+
+  /* The texture atlas is created again with the format of the rendering style
+   * when it is empty (see __glcTextureAtlasGetPosition()).
+   */
+  if (inAtlas && inContext->atlas.id && inContext->atlasCount)
+    format = inContext->atlas.format;
+  else
+    format = __glcTextureGetFormat(inContext);
+
+  if ((format == GL_RGBA8) && __glcTextureGetSdfProgram(inContext)) {
+    glEnable(GL_FRAGMENT_PROGRAM_ARB);
+    return GL_TRUE;
+  }
+
+  glEnable(GL_ALPHA_TEST);
+  glAlphaFunc(GL_GEQUAL, .5f);
+  return GL_FALSE;
+}
+
+
+
 /* This function gets some room in the texture atlas for a new glyph 'inGlyph'.
  * Eventually it creates the texture atlas, if it does not exist yet.
  */
@@ -59,6 +707,18 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
 					      __GLCglyph* inGlyph)
 {
   __GLCatlasElement* atlasNode = NULL;
+  int pinned = 0;
+  const GLint internalFormat = __glcTextureGetFormat(inContext);
+
+  /* The texture atlas is created again if it is empty and if its format does
+   * not match the rendering style. Otherwise the glyphs are stored in the
+   * format of the atlas (see __glcRenderCharTexture()).
+   */
+  if (inContext->atlas.id && !inContext->atlasCount
+      && (inContext->atlas.format != internalFormat)) {
+    glDeleteTextures(1, &inContext->atlas.id);
+    inContext->atlas.id = 0;
+  }
 
   /* Test if the atlas already exists. If not, create it. */
   if (!inContext->atlas.id) {
@@ -67,6 +727,9 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
     GLint format = 0;
     GLint level = 0;
     void * buffer = NULL;
+    const GLenum pixelFormat = (internalFormat == GL_RGBA8) ?
+      GL_RGBA : GL_ALPHA;
+    const int texelSize = (internalFormat == GL_RGBA8) ? 4 : 1;
 
     /* Not all gfx card are able to use 1024x1024 textures (especially old ones
      * like 3dfx's). Moreover, the texture memory may be scarce when our texture
@@ -77,8 +740,8 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
      * routine aborts with GLC_RESOURCE_ERROR raised.
      */
     for (i = 0; i < 3; i++) {
-      glTexImage2D(GL_PROXY_TEXTURE_2D, 0, GL_ALPHA8, size,
-		   size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, NULL);
+      glTexImage2D(GL_PROXY_TEXTURE_2D, 0, internalFormat, size,
+		   size, 0, pixelFormat, GL_UNSIGNED_BYTE, NULL);
       glGetTexLevelParameteriv(GL_PROXY_TEXTURE_2D, 0, GL_TEXTURE_COMPONENTS,
 			       &format);
       if (format)
@@ -93,12 +756,12 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
       return GL_FALSE;
     }
 
-    buffer = __glcMalloc(size * size);
+    buffer = __glcMalloc(size * size * texelSize);
     if (!buffer) {
       __glcRaiseError(GLC_RESOURCE_ERROR);
       return GL_FALSE;
     }
-    memset(buffer, 0, size * size);
+    memset(buffer, 0, size * size * texelSize);
 
     /* Create the texture atlas structure. The texture is divided in small
      * square areas of GLC_TEXTURE_SIZE x GLC_TEXTURE_SIZE, each of which will
@@ -109,12 +772,13 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
     glGenTextures(1, &inContext->atlas.id);
     inContext->atlas.width = size;
     inContext->atlas.height = size;
+    inContext->atlas.format = internalFormat;
     inContext->atlasWidth = size / GLC_TEXTURE_SIZE;
     inContext->atlasHeight = size / GLC_TEXTURE_SIZE;
     inContext->atlasCount = 0;
     glBindTexture(GL_TEXTURE_2D, inContext->atlas.id);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, size,
-		 size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, buffer);
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size,
+		 size, 0, pixelFormat, GL_UNSIGNED_BYTE, buffer);
 
     /* Create the mipmap structure of the texture atlas, no matter if GLC_MIPMAP
      * is enabled or not.
@@ -122,8 +786,8 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
     while (size > 1) {
       size >>= 1;
       level++;
-      glTexImage2D(GL_TEXTURE_2D, level, GL_ALPHA8, size,
-		   size, 0, GL_ALPHA, GL_UNSIGNED_BYTE, buffer);
+      glTexImage2D(GL_TEXTURE_2D, level, internalFormat, size,
+		   size, 0, pixelFormat, GL_UNSIGNED_BYTE, buffer);
     }
 
     /* Use trilinear filtering if GLC_MIPMAP is enabled.
@@ -145,13 +809,13 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
      * around the f***ing bug.
      */
     size = GLC_TEXTURE_SIZE;
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, GL_ALPHA,
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size, size, pixelFormat,
 		    GL_UNSIGNED_BYTE, buffer);
     level = 0;
     while (size > 2) {
       size >>= 1;
       level++;
-      glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, size, size, GL_ALPHA,
+      glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, size, size, pixelFormat,
 		      GL_UNSIGNED_BYTE, buffer);
     }
 
@@ -192,9 +856,23 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
     atlasNode = (__GLCatlasElement*)inContext->atlasList.tail;
     assert(atlasNode);
 
+    /* The areas that are pinned by the text objects can not be released. They
+     * are moved to the head of the list so that the next evictions do not go
+     * through them again.
+     */
+    while (atlasNode->pinCount) {
+      if (++pinned == inContext->atlasCount) {
+	__glcRaiseError(GLC_RESOURCE_ERROR);
+	return GL_FALSE;
+      }
+      FT_List_Up(&inContext->atlasList, (FT_ListNode)atlasNode);
+      atlasNode = (__GLCatlasElement*)inContext->atlasList.tail;
+    }
+
     if (atlasNode->glyph) {
       /* Release the texture area of the glyph */
       __glcGlyphDestroyTexture(atlasNode->glyph, inContext);
+      GLC_STAT_INC(inContext, GLC_ATLAS_EVICTION_COUNT_QSO);
     }
     /* Put the texture area at the head of the list otherwise we will use the
      * same texture element over and over again each time that we need to
@@ -206,20 +884,20 @@ static GLboolean __glcTextureAtlasGetPosition(__GLCcontext* inContext,
     /* The texture atlas is not full. We create a new texture area and we store
      * its definition in atlas list.
      */
-    atlasNode = (__GLCatlasElement*)__glcMalloc(sizeof(__GLCatlasElement));
-    if (!atlasNode) {
-      __glcRaiseError(GLC_RESOURCE_ERROR);
+    atlasNode = (__GLCatlasElement*)__glcPoolAlloc(inContext->atlasPool);
+    if (!atlasNode)
       return GL_FALSE;
-    }
 
     atlasNode->node.data = atlasNode;
     atlasNode->position = inContext->atlasCount++;
+    atlasNode->pinCount = 0;
     FT_List_Insert(&inContext->atlasList, (FT_ListNode)atlasNode);
   }
 
   /* Update the texture element */
   atlasNode->glyph = inGlyph;
   inGlyph->textureObject = atlasNode;
+  GLC_STAT_INC(inContext, GLC_ATLAS_ALLOC_COUNT_QSO);
 
   if (GLEW_ARB_vertex_buffer_object) {
     /* Create a VBO, if none exists yet */
@@ -253,13 +931,18 @@ static GLboolean __glcTextureGetImmediate(__GLCcontext* inContext,
   GLint format = 0;
   GLsizei width = inWidth;
   GLsizei height = inHeight;
+  const GLint internalFormat = __glcTextureGetFormat(inContext);
+  const GLenum pixelFormat = (internalFormat == GL_RGBA8) ? GL_RGBA : GL_ALPHA;
 
   /* Check if a texture exists to store the glyph */
   if (inContext->texture.id) {
-    /* Check if the texture size is large enough to store the glyph */
+    /* Check if the texture size is large enough to store the glyph and if its
+     * format matches the rendering style.
+     */
     if ((inWidth > inContext->texture.width)
-	|| (inHeight > inContext->texture.height)) {
-      /* The texture is not large enough so we destroy the current texture */
+	|| (inHeight > inContext->texture.height)
+	|| (inContext->texture.format != internalFormat)) {
+      /* The texture can not be used so we destroy the current texture */
       glDeleteTextures(1, &inContext->texture.id);
       width = (inWidth > inContext->texture.width) ?
 	inWidth : inContext->texture.width;
@@ -281,8 +964,8 @@ static GLboolean __glcTextureGetImmediate(__GLCcontext* inContext,
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 
   /* Check if a new texture can be created */
-  glTexImage2D(GL_PROXY_TEXTURE_2D, 0, GL_ALPHA8, width, height, 0, GL_ALPHA,
-	       GL_UNSIGNED_BYTE, NULL);
+  glTexImage2D(GL_PROXY_TEXTURE_2D, 0, internalFormat, width, height, 0,
+	       pixelFormat, GL_UNSIGNED_BYTE, NULL);
   glGetTexLevelParameteriv(GL_PROXY_TEXTURE_2D, 0, GL_TEXTURE_COMPONENTS,
 			   &format);
   /* TODO: If the texture creation fails, try with a smaller size */
@@ -294,8 +977,8 @@ static GLboolean __glcTextureGetImmediate(__GLCcontext* inContext,
   /* Create a texture object and make it current */
   glGenTextures(1, &inContext->texture.id);
   glBindTexture(GL_TEXTURE_2D, inContext->texture.id);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA8, width, height, 0, GL_ALPHA,
-	       GL_UNSIGNED_BYTE, NULL);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0,
+	       pixelFormat, GL_UNSIGNED_BYTE, NULL);
   /* For immediate mode rendering, always use bilinear filtering even if
    * GLC_MIPMAP is enabled : we have determined the size of the glyph when it
    * will be rendered on the screen and the texture size has been defined
@@ -309,8 +992,13 @@ static GLboolean __glcTextureGetImmediate(__GLCcontext* inContext,
 
   inContext->texture.width = width;
   inContext->texture.height = height;
+  inContext->texture.format = internalFormat;
 
-  if (GLEW_ARB_pixel_buffer_object) {
+  /* The distance field of the GLC_SDF_QSO rendering style is computed in the
+   * client memory, so no PBO is needed.
+   */
+  if (GLEW_ARB_pixel_buffer_object
+      && (inContext->renderState.renderStyle == GLC_TEXTURE)) {
     /* Create a PBO, if none exists yet */
     if (!inContext->texture.bufferObjectID) {
       glGenBuffersARB(1, &inContext->texture.bufferObjectID);
@@ -348,6 +1036,19 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
   GLint pixBoundingBox[4] = {0, 0, 0, 0};
   int minSize = (GLEW_VERSION_1_2 || GLEW_SGIS_texture_lod) ? 2 : 1;
   GLfloat texWidth = 0.f, texHeight = 0.f;
+  /* The distance field is computed in the client memory hence the PBO can not
+   * be used by the GLC_SDF_QSO rendering style.
+   */
+  const GLboolean usePBO = (GLEW_ARB_pixel_buffer_object
+			    && !inContext->enableState.glObjects
+			    && (inContext->renderState.renderStyle
+				== GLC_TEXTURE));
+  __GLCrendererData rendererData;
+  GLfloat scaleMatrix[16] = {1.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+				0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f};
+  GLboolean isRGBA = GL_FALSE;
+  GLenum pixelFormat = GL_ALPHA;
+  int texelSize = 1;
 
   if (inContext->enableState.glObjects) {
     __GLCatlasElement* atlasNode = NULL;
@@ -385,12 +1086,40 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
     texY = 0;
   }
 
-  if (!inContext->texture.bufferObjectID || inContext->enableState.glObjects) {
-    pixBuffer = (GLubyte *)__glcMalloc(pixWidth * pixHeight);
-    if (!pixBuffer) {
-      __glcRaiseError(GLC_RESOURCE_ERROR);
+  /* The glyphs are stored in the format of the texture which may not be the
+   * format of the rendering style if the texture atlas is pinned by text
+   * objects of the other style : the GLC_SDF_QSO glyphs are then stored without
+   * their multi-channel field and the GLC_TEXTURE glyphs with white RGB
+   * channels.
+   */
+  if ((inContext->enableState.glObjects ? inContext->atlas.format
+       : inContext->texture.format) == GL_RGBA8) {
+    isRGBA = GL_TRUE;
+    pixelFormat = GL_RGBA;
+    texelSize = 4;
+  }
+
+  if (!inContext->texture.bufferObjectID || !usePBO) {
+    pixBuffer = (GLubyte *)__glcArenaAlloc(inContext->arena,
+					   pixWidth * pixHeight * texelSize);
+    if (!pixBuffer)
       return;
-    }
+  }
+
+  if (inContext->renderState.renderStyle == GLC_SDF_QSO) {
+    /* The contours are flattened with a tolerance of 1/8th of pixel (the
+     * tolerance of the flattening is a squared distance).
+     */
+    scaleMatrix[0] = 1.f / 64.f;
+    scaleMatrix[5] = 1.f / 64.f;
+    rendererData.tolerance = 1.f / 64.f;
+    rendererData.vertexArray = inContext->vertexArray;
+    rendererData.endContour = inContext->endContour;
+    rendererData.vertexIndices = inContext->vertexIndices;
+    rendererData.geomBatches = inContext->geomBatches;
+    rendererData.transformMatrix = scaleMatrix;
+    rendererData.halfWidth = 0.5f;
+    rendererData.halfHeight = 0.5f;
   }
 
   /* Create the texture */
@@ -403,7 +1132,7 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
 
   /* Iterate on the powers of 2 in order to build the mipmap */
   do {
-    if (GLEW_ARB_pixel_buffer_object && !inContext->enableState.glObjects) {
+    if (usePBO) {
       pixBuffer = (GLubyte *)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,
 					    GL_WRITE_ONLY_ARB);
       if (!pixBuffer) {
@@ -412,27 +1141,72 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
       }
     }
 
+    if (inContext->renderState.renderStyle == GLC_SDF_QSO) {
+      /* Compute the distance field of the glyph from its contours. The
+       * spread of the distance field is divided by 2 at each mipmap level so
+       * that it remains the same in the object space.
+       */
+      if (!__glcFaceDescGetBitmapContours(inFont->faceDesc, pixWidth,
+					  pixHeight, &rendererData,
+					  inContext)) {
+	glPopClientAttrib();
+	__glcArenaFree(inContext->arena, pixBuffer);
+	return;
+      }
+
+      if (!__glcTextureComputeDistanceField(pixBuffer, pixWidth, pixHeight,
+					    (GLfloat)GLC_SDF_SPREAD
+					    / (1 << level), &rendererData,
+					    inContext->arena, isRGBA)) {
+	GLC_ARRAY_LENGTH(rendererData.vertexArray) = 0;
+	GLC_ARRAY_LENGTH(rendererData.endContour) = 0;
+	glPopClientAttrib();
+	__glcArenaFree(inContext->arena, pixBuffer);
+	return;
+      }
+      GLC_ARRAY_LENGTH(rendererData.vertexArray) = 0;
+      GLC_ARRAY_LENGTH(rendererData.endContour) = 0;
+    }
     /* render the glyph */
-    if (!__glcFaceDescGetBitmap(inFont->faceDesc, pixWidth, pixHeight,
-                                pixBuffer, inContext)) {
+    else if (!__glcFaceDescGetBitmap(inFont->faceDesc, pixWidth, pixHeight,
+				     pixBuffer, inContext)) {
       glPopClientAttrib();
 
-      if (GLEW_ARB_pixel_buffer_object && !inContext->enableState.glObjects)
+      if (usePBO)
         glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
       else
-        __glcFree(pixBuffer);
+        __glcArenaFree(inContext->arena, pixBuffer);
 
       return;
     }
+    else if (isRGBA) {
+      /* Expand the coverage of the glyph to the alpha channel of white
+       * texels.
+       */
+      GLubyte* texels = (GLubyte*)pixBuffer;
+      int i = 0;
+
+      for (i = pixWidth * pixHeight - 1; i >= 0; i--) {
+	const GLubyte coverage = texels[i];
+
+	texels[4 * i] = 255;
+	texels[4 * i + 1] = 255;
+	texels[4 * i + 2] = 255;
+	texels[4 * i + 3] = coverage;
+      }
+    }
 
-    if (GLEW_ARB_pixel_buffer_object && !inContext->enableState.glObjects) {
+    if (usePBO) {
       glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
       pixBuffer = NULL;
     }
 
     glTexSubImage2D(GL_TEXTURE_2D, level, texX >> level, texY >> level,
-		    pixWidth, pixHeight, GL_ALPHA, GL_UNSIGNED_BYTE,
+		    pixWidth, pixHeight, pixelFormat, GL_UNSIGNED_BYTE,
 		    pixBuffer);
+    GLC_STAT_INC(inContext, GLC_TEXTURE_UPLOAD_COUNT_QSO);
+    GLC_STAT_ADD(inContext, GLC_TEXTURE_UPLOAD_BYTES_QSO,
+		 pixWidth * pixHeight * texelSize);
 
     /* A mipmap is built only if a display list is currently building
      * otherwise it adds useless computations
@@ -460,12 +1234,16 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
        * not support texture levels.
        */
       assert(!GLEW_ARB_pixel_buffer_object);
-      memset(pixBuffer, 0, pixWidth * pixHeight);
+      memset(pixBuffer, 0, pixWidth * pixHeight * texelSize);
       while ((pixWidth > 0) || (pixHeight > 0)) {
 	glTexSubImage2D(GL_TEXTURE_2D, level, texX >> level, texY >> level,
 		     pixWidth ? pixWidth : 1,
-		     pixHeight ? pixHeight : 1, GL_ALPHA,
+		     pixHeight ? pixHeight : 1, pixelFormat,
 		     GL_UNSIGNED_BYTE, pixBuffer);
+	GLC_STAT_INC(inContext, GLC_TEXTURE_UPLOAD_COUNT_QSO);
+	GLC_STAT_ADD(inContext, GLC_TEXTURE_UPLOAD_BYTES_QSO,
+		     (pixWidth ? pixWidth : 1) * (pixHeight ? pixHeight : 1)
+		     * texelSize);
 
 	level++;
 	pixWidth >>= 1;
@@ -477,29 +1255,43 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
   glPopClientAttrib();
 
   if (pixBuffer)
-    __glcFree(pixBuffer);
+    __glcArenaFree(inContext->arena, pixBuffer);
 
   /* Add the new texture to the texture list and the new display list
    * to the list of display lists
    */
   if (inContext->enableState.glObjects) {
+    __GLCatlasElement* atlasNode = inGlyph->textureObject;
+    GLfloat* rect = inGlyph->records->atlasRect[inGlyph->record];
+
+    /* Store the quad of the glyph in the render records of its face, from
+     * which the batched render loop reads it.
+     */
+    rect[0] = texX / texWidth;
+    rect[1] = texY / texHeight;
+    rect[2] = (texX + GLC_TEXTURE_SIZE - 1) / texWidth;
+    rect[3] = (texY + GLC_TEXTURE_SIZE - 1) / texHeight;
+    rect[4] = pixBoundingBox[0] / 64. / GLC_TEXTURE_SIZE;
+    rect[5] = pixBoundingBox[1] / 64. / GLC_TEXTURE_SIZE;
+    rect[6] = pixBoundingBox[2] / 64. / GLC_TEXTURE_SIZE;
+    rect[7] = pixBoundingBox[3] / 64. / GLC_TEXTURE_SIZE;
+
     if (GLEW_ARB_vertex_buffer_object) {
       GLfloat* buffer = NULL;
       GLfloat* data = NULL;
-      __GLCatlasElement* atlasNode = inGlyph->textureObject;
 
-      buffer = (GLfloat*)__glcMalloc(inContext->atlasWidth
-				     * inContext->atlasHeight * 20
-				     * sizeof(GLfloat));
-      if (!buffer) {
-	__glcRaiseError(GLC_RESOURCE_ERROR);
+      buffer = (GLfloat*)__glcArenaAlloc(inContext->arena,
+					 inContext->atlasWidth
+					 * inContext->atlasHeight * 20
+					 * sizeof(GLfloat));
+      if (!buffer)
 	return;
-      }
 
       /* The display list ID is used as a flag to declare that the VBO has been
        * initialized and can be used.
        */
       inGlyph->glObject[1] = 0xffffffff;
+      inGlyph->records->atlasVertex[inGlyph->record] = atlasNode->position * 4;
 
       /* Here we do not use the GL command glBufferSubData() since it seems to
        * be buggy on some GL drivers (the DRI Intel specifically).
@@ -512,35 +1304,14 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
 	data = (GLfloat*)glMapBufferARB(GL_ARRAY_BUFFER_ARB, GL_READ_ONLY);
 	if (!data) {
 	  __glcRaiseError(GLC_RESOURCE_ERROR);
-	  __glcFree(buffer);
+	  __glcArenaFree(inContext->arena, buffer);
 	  return;
 	}
 	memcpy(buffer, data, inContext->atlasCount * 20 * sizeof(GLfloat));
 	glUnmapBufferARB(GL_ARRAY_BUFFER_ARB);
       }
 
-      data = buffer + atlasNode->position * 20;
-
-      data[0] = texX / texWidth;
-      data[1] = texY / texHeight;
-      data[2] = pixBoundingBox[0] / 64. / GLC_TEXTURE_SIZE;
-      data[3] = pixBoundingBox[1] / 64. / GLC_TEXTURE_SIZE;
-      data[4] = 0.f;
-      data[5] = (texX + GLC_TEXTURE_SIZE - 1) / texWidth;
-      data[6] = data[1];
-      data[7] = pixBoundingBox[2] / 64.	/ GLC_TEXTURE_SIZE;
-      data[8] = data[3];
-      data[9] = 0.f;
-      data[10] = data[5];
-      data[11] = (texY + GLC_TEXTURE_SIZE - 1) / texHeight;
-      data[12] = data[7];
-      data[13] = pixBoundingBox[3] / 64. / GLC_TEXTURE_SIZE;
-      data[14] = 0.f;
-      data[15] = data[0];
-      data[16] = data[11];
-      data[17] = data[2];
-      data[18] = data[13];
-      data[19] = 0.f;
+      __glcAtlasRectToQuad(buffer + atlasNode->position * 20, rect, 0.f, 0.f);
 
       /* Size of the buffer data is equal to the number of glyphes than can be
        * stored in the texture times 20 GLfloat (4 vertices made of 3D
@@ -549,12 +1320,17 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
       glBufferDataARB(GL_ARRAY_BUFFER_ARB,
 		      inContext->atlasWidth * inContext->atlasHeight
 		      * 20 * sizeof(GLfloat), buffer, GL_STATIC_DRAW_ARB);
+      GLC_STAT_INC(inContext, GLC_BUFFER_UPLOAD_COUNT_QSO);
+      GLC_STAT_ADD(inContext, GLC_BUFFER_UPLOAD_BYTES_QSO,
+		   inContext->atlasWidth * inContext->atlasHeight
+		   * 20 * sizeof(GLfloat));
 
-      __glcFree(buffer);
+      __glcArenaFree(inContext->arena, buffer);
 
       /* Do the actual GL rendering */
       glInterleavedArrays(GL_T2F_V3F, 0, NULL);
       glDrawArrays(GL_QUADS, atlasNode->position * 4, 4);
+      GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
 
       return;
     }
@@ -564,6 +1340,7 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
 	__glcRaiseError(GLC_RESOURCE_ERROR);
 	return;
       }
+      inGlyph->records->atlasVertex[inGlyph->record] = atlasNode->position * 4;
 
       /* Create the display list */
       glNewList(inGlyph->glObject[1], GL_COMPILE);
@@ -599,4 +1376,6 @@ void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
     glEndList();
     glCallList(inGlyph->glObject[1]);
   }
+
+  GLC_STAT_INC(inContext, GLC_DRAW_CALL_COUNT_QSO);
 }
@@ -28,15 +28,52 @@
 #include "ofont.h"
 
 #define GLC_TEXTURE_SIZE        64
+#define GLC_SDF_SPREAD          4
 
 struct __GLCatlasElementRec {
   FT_ListNodeRec node;
 
   int position;
   __GLCglyph* glyph;
+  int pinCount;			/* Text objects which draw this area */
 };
 
+/* Write in 'outQuad' the 4 vertices of the quad described by the atlas
+ * rectangle 'inRect' (see __GLCrenderRecords) translated by (inX, inY). The
+ * vertices are stored in the GL_T2F_V3F format that is 20 GLfloat per quad.
+ */
+static inline void __glcAtlasRectToQuad(GLfloat* outQuad,
+					const GLfloat* inRect,
+					const GLfloat inX, const GLfloat inY)
+{
+  outQuad[0] = inRect[0];
+  outQuad[1] = inRect[1];
+  outQuad[2] = inRect[4] + inX;
+  outQuad[3] = inRect[5] + inY;
+  outQuad[4] = 0.f;
+  outQuad[5] = inRect[2];
+  outQuad[6] = inRect[1];
+  outQuad[7] = inRect[6] + inX;
+  outQuad[8] = outQuad[3];
+  outQuad[9] = 0.f;
+  outQuad[10] = inRect[2];
+  outQuad[11] = inRect[3];
+  outQuad[12] = outQuad[7];
+  outQuad[13] = inRect[7] + inY;
+  outQuad[14] = 0.f;
+  outQuad[15] = inRect[0];
+  outQuad[16] = inRect[3];
+  outQuad[17] = outQuad[2];
+  outQuad[18] = outQuad[13];
+  outQuad[19] = 0.f;
+}
+
 void __glcReleaseAtlasElement(__GLCatlasElement* This, __GLCcontext* inContext);
+void __glcPinAtlasElement(__GLCatlasElement* This, __GLCcontext* inContext);
+void __glcUnpinAtlasElement(__GLCatlasElement* This, __GLCcontext* inContext);
+void __glcTextureAtlasFlush(__GLCcontext* inContext);
+GLboolean __glcTextureEnableSdf(__GLCcontext* inContext,
+				const GLboolean inAtlas);
 void __glcRenderCharTexture(const __GLCfont* inFont, __GLCcontext* inContext,
 			    const GLfloat inScaleX, const GLfloat inScaleY,
 			    __GLCglyph* inGlyph);
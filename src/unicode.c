@@ -25,6 +25,7 @@
  *  defines the routines used to manipulate Unicode strings and characters
  */
 
+#include <limits.h>
 #include <fribidi/fribidi.h>
 
 #include "internal.h"
@@ -234,6 +235,63 @@ static int __glcUtf8ToUcs2(const GLCchar8* src_orig,
 
 
 
+/* Convert at most 'inCount' characters of the UTF-8 string 'inString' to UCS4
+ * and store them in 'outString'. 'inLength' is the number of bytes that can be
+ * read from 'inString'. The string is decoded in a single pass : runs of ASCII
+ * characters are checked and copied one machine word at a time, the other
+ * characters are decoded by FcUtf8ToUcs4(). A word is only read if at least
+ * as many characters remain to be decoded, so the function never reads beyond
+ * the end of the string.
+ * The function returns the number of characters decoded, or -1 if the string
+ * is ill-formed.
+ */
+static int __glcUtf8ToUcs4String(const GLCchar8* inString, const int inLength,
+				 GLCchar32* outString, const int inCount)
+{
+  const size_t highBits = ((size_t)-1 / 0xff) * 0x80;
+  const int wordSize = (int)sizeof(size_t);
+  int pos = 0;
+  int count = 0;
+
+  while ((pos < inLength) && (count < inCount)) {
+    int shift = 0;
+
+    if ((inLength - pos >= wordSize) && (inCount - count >= wordSize)) {
+      size_t word = 0;
+
+      memcpy(&word, inString + pos, wordSize);
+      if (!(word & highBits)) {
+	int i = 0;
+
+	for (i = 0; i < wordSize; i++)
+	  outString[count + i] = inString[pos + i];
+
+	pos += wordSize;
+	count += wordSize;
+	continue;
+      }
+    }
+
+    if (inString[pos] < 0x80) {
+      outString[count++] = inString[pos++];
+      continue;
+    }
+
+    shift = FcUtf8ToUcs4(inString + pos, outString + count,
+			 (inLength - pos < FC_UTF8_MAX_LEN) ?
+			 inLength - pos : FC_UTF8_MAX_LEN);
+    if (shift < 0)
+      return -1;
+
+    pos += shift;
+    count++;
+  }
+
+  return count;
+}
+
+
+
 /* Convert 'inString' in the UTF-8 format and return a copy of the converted
  * string.
  */
@@ -335,9 +393,12 @@ GLCchar* __glcConvertFromUtf8ToBuffer(__GLCcontext* This,
   int len_buffer = 0;
   int len = 0;
   int shift = 0;
+  int length = 0;
 
   assert(inString);
 
+  length = strlen((const char*)inString);
+
   switch(This->stringState.stringType) {
   case GLC_UCS1:
     {
@@ -347,7 +408,7 @@ GLCchar* __glcConvertFromUtf8ToBuffer(__GLCcontext* This,
       /* Determine the length of the final string */
       utf8 = inString;
       while(*utf8) {
-	shift = __glcUtf8ToUcs1(utf8, buffer, strlen((const char*)utf8),
+	shift = __glcUtf8ToUcs1(utf8, buffer, length - (utf8 - inString),
 				&len_buffer);
 	if (shift < 0) {
 	  /* There is an ill-formed character in the UTF-8 string, abort */
@@ -367,7 +428,7 @@ GLCchar* __glcConvertFromUtf8ToBuffer(__GLCcontext* This,
       ucs1 = (GLCchar8*)string;
       utf8 = inString;
       while(*utf8) {
-	utf8 += __glcUtf8ToUcs1(utf8, ucs1, strlen((const char*)utf8),
+	utf8 += __glcUtf8ToUcs1(utf8, ucs1, length - (utf8 - inString),
 				&len_buffer);
 	ucs1 += len_buffer;
       }
@@ -383,7 +444,7 @@ GLCchar* __glcConvertFromUtf8ToBuffer(__GLCcontext* This,
       /* Determine the length of the final string */
       utf8 = inString;
       while(*utf8) {
-	shift = __glcUtf8ToUcs2(utf8, buffer, strlen((const char*)utf8),
+	shift = __glcUtf8ToUcs2(utf8, buffer, length - (utf8 - inString),
 				&len_buffer);
 	if (shift < 0) {
 	  /* There is an ill-formed character in the UTF-8 string, abort */
@@ -403,7 +464,7 @@ GLCchar* __glcConvertFromUtf8ToBuffer(__GLCcontext* This,
       ucs2 = (GLCchar16*)string;
       utf8 = inString;
       while(*utf8) {
-	utf8 += __glcUtf8ToUcs2(utf8, ucs2, strlen((const char*)utf8),
+	utf8 += __glcUtf8ToUcs2(utf8, ucs2, length - (utf8 - inString),
 				&len_buffer);
 	ucs2 += len_buffer;
       }
@@ -412,44 +473,31 @@ GLCchar* __glcConvertFromUtf8ToBuffer(__GLCcontext* This,
     break;
   case GLC_UCS4:
     {
-      GLCchar32 buffer = 0;
-      GLCchar32* ucs4 = NULL;
-
-      /* Determine the length of the final string */
-      utf8 = inString;
-      while(*utf8) {
-	shift = FcUtf8ToUcs4(utf8, &buffer, strlen((const char*)utf8));
-	if (shift < 0) {
-	  /* There is an ill-formed character in the UTF-8 string, abort */
-	  __glcRaiseError(GLC_PARAMETER_ERROR);
-	  return NULL;
-	}
-	utf8 += shift;
-	len++;
-      }
-
-      /* Allocate the room to store the final string */
+      /* Allocate the room to store the final string : the number of
+       * characters can not exceed the number of bytes of the UTF-8 string.
+       */
       string = (GLCchar*)__glcContextQueryBuffer(This,
-						 (len+1)*sizeof(GLCchar32));
+						 (length+1)*sizeof(GLCchar32));
       if (!string)
 	return NULL; /* GLC_RESOURCE_ERROR has been raised */
 
-
       /* Perform the conversion */
-      utf8 = inString;
-      ucs4 = (GLCchar32*)string;
-      while(*utf8)
-	utf8 += FcUtf8ToUcs4(utf8, ucs4++, strlen((const char*)utf8));
+      len = __glcUtf8ToUcs4String(inString, length, (GLCchar32*)string,
+				  length);
+      if (len < 0) {
+	/* There is an ill-formed character in the UTF-8 string, abort */
+	__glcRaiseError(GLC_PARAMETER_ERROR);
+	return NULL;
+      }
 
-      *ucs4 = 0; /* Add the '\0' termination of the string */
+      ((GLCchar32*)string)[len] = 0; /* Add the '\0' termination of the string */
     }
     break;
   case GLC_UTF8_QSO:
     /* If the string is already encoded in UTF-8 format then all we need to do
      * is to make a copy of it.
      */
-    string = (GLCchar*)__glcContextQueryBuffer(This,
-				 	       strlen((const char*)inString)+1);
+    string = (GLCchar*)__glcContextQueryBuffer(This, length+1);
     if (!string)
       return NULL; /* GLC_RESOURCE_ERROR has been raised */
     strcpy((char*)string, (const char*)inString);
@@ -549,20 +597,391 @@ GLint __glcConvertGLintToUcs4(const __GLCcontext *inContext, GLint inCode)
 
 
 
+/* Check if the characters of a UCS4 string may need to be reordered by the
+ * bidirectional algorithm : the function returns GL_TRUE as soon as it finds
+ * a character of a right-to-left script or a bidirectional control character.
+ * The test is conservative : whole blocks of the Unicode space are considered
+ * right-to-left. Most strings only contain characters below U+0400, so the
+ * string is scanned by blocks of 8 characters which are skipped at once when
+ * the OR of their codes is below U+0400.
+ */
+static GLboolean __glcStringNeedsBidi(const GLCchar32* inString,
+				      const GLint inLength)
+{
+  GLint i = 0;
+
+  while (i < inLength) {
+    GLCchar32 c = 0;
+
+    if (inLength - i >= 8) {
+      GLCchar32 bits = inString[i] | inString[i+1] | inString[i+2]
+	| inString[i+3] | inString[i+4] | inString[i+5] | inString[i+6]
+	| inString[i+7];
+
+      if (bits < 0x400) {
+	i += 8;
+	continue;
+      }
+    }
+
+    c = inString[i++];
+    if (c < 0x590)
+      continue;
+
+    if ((c <= 0x8ff)			/* Hebrew to Arabic Extended-A */
+	|| (c == 0x200e) || (c == 0x200f)	/* LRM and RLM */
+	|| ((c >= 0x202a) && (c <= 0x202e))	/* Embeddings and overrides */
+	|| ((c >= 0x2066) && (c <= 0x2069))	/* Isolates */
+	|| ((c >= 0xfb1d) && (c <= 0xfdff))	/* Hebrew and Arabic forms */
+	|| ((c >= 0xfe70) && (c <= 0xfeff))	/* Arabic presentation forms */
+	|| ((c >= 0x10800) && (c <= 0x10fff))	/* RTL scripts of the SMP */
+	|| ((c >= 0x1e800) && (c <= 0x1efff)))	/* Adlam, Arabic math, ... */
+      return GL_TRUE;
+  }
+
+  return GL_FALSE;
+}
+
+
+/* Contextual forms of the Arabic letters. For each letter, 'form' is its
+ * isolated form in the Arabic Presentation Forms blocks. It is followed by the
+ * final form and, for the letters which join on both sides, by the initial
+ * and the medial forms. 'count' is the number of forms of the letter.
+ */
+static const struct {
+  GLCchar16 code;
+  GLCchar16 form;
+  GLint count;
+} __glcArabicForms[] = {
+  {0x0621, 0xfe80, 1}, {0x0622, 0xfe81, 2}, {0x0623, 0xfe83, 2},
+  {0x0624, 0xfe85, 2}, {0x0625, 0xfe87, 2}, {0x0626, 0xfe89, 4},
+  {0x0627, 0xfe8d, 2}, {0x0628, 0xfe8f, 4}, {0x0629, 0xfe93, 2},
+  {0x062a, 0xfe95, 4}, {0x062b, 0xfe99, 4}, {0x062c, 0xfe9d, 4},
+  {0x062d, 0xfea1, 4}, {0x062e, 0xfea5, 4}, {0x062f, 0xfea9, 2},
+  {0x0630, 0xfeab, 2}, {0x0631, 0xfead, 2}, {0x0632, 0xfeaf, 2},
+  {0x0633, 0xfeb1, 4}, {0x0634, 0xfeb5, 4}, {0x0635, 0xfeb9, 4},
+  {0x0636, 0xfebd, 4}, {0x0637, 0xfec1, 4}, {0x0638, 0xfec5, 4},
+  {0x0639, 0xfec9, 4}, {0x063a, 0xfecd, 4}, {0x0641, 0xfed1, 4},
+  {0x0642, 0xfed5, 4}, {0x0643, 0xfed9, 4}, {0x0644, 0xfedd, 4},
+  {0x0645, 0xfee1, 4}, {0x0646, 0xfee5, 4}, {0x0647, 0xfee9, 4},
+  {0x0648, 0xfeed, 2}, {0x0649, 0xfeef, 2}, {0x064a, 0xfef1, 4},
+  {0x0671, 0xfb50, 2}, {0x0677, 0xfbdd, 1}, {0x0679, 0xfb66, 4},
+  {0x067a, 0xfb5e, 4}, {0x067b, 0xfb52, 4}, {0x067e, 0xfb56, 4},
+  {0x067f, 0xfb62, 4}, {0x0680, 0xfb5a, 4}, {0x0683, 0xfb76, 4},
+  {0x0684, 0xfb72, 4}, {0x0686, 0xfb7a, 4}, {0x0687, 0xfb7e, 4},
+  {0x0688, 0xfb88, 2}, {0x068c, 0xfb84, 2}, {0x068d, 0xfb82, 2},
+  {0x068e, 0xfb86, 2}, {0x0691, 0xfb8c, 2}, {0x0698, 0xfb8a, 2},
+  {0x06a4, 0xfb6a, 4}, {0x06a6, 0xfb6e, 4}, {0x06a9, 0xfb8e, 4},
+  {0x06ad, 0xfbd3, 4}, {0x06af, 0xfb92, 4}, {0x06b1, 0xfb9a, 4},
+  {0x06b3, 0xfb96, 4}, {0x06ba, 0xfb9e, 2}, {0x06bb, 0xfba0, 4},
+  {0x06be, 0xfbaa, 4}, {0x06c0, 0xfba4, 2}, {0x06c1, 0xfba6, 4},
+  {0x06c5, 0xfbe0, 2}, {0x06c6, 0xfbd9, 2}, {0x06c7, 0xfbd7, 2},
+  {0x06c8, 0xfbdb, 2}, {0x06c9, 0xfbe2, 2}, {0x06cb, 0xfbde, 2},
+  {0x06cc, 0xfbfc, 4}, {0x06d0, 0xfbe4, 4}, {0x06d2, 0xfbae, 2},
+  {0x06d3, 0xfbb0, 2}
+};
+
+#define GLC_JOINING_NONE	0
+#define GLC_JOINING_RIGHT	1
+#define GLC_JOINING_DUAL	2
+#define GLC_JOINING_TRANSPARENT	3
+
+
+
+/* Return the joining type of the character 'inCode'. If it is an Arabic
+ * letter which has contextual forms, its index in __glcArabicForms is
+ * returned in 'outIndex', otherwise 'outIndex' is set to -1.
+ */
+static GLint __glcGetJoiningType(const GLCchar32 inCode, GLint* outIndex)
+{
+  GLint lower = 0;
+  GLint upper = sizeof(__glcArabicForms) / sizeof(__glcArabicForms[0]) - 1;
+
+  *outIndex = -1;
+
+  /* Combining marks do not break the joining of the letters around them */
+  if (((inCode >= 0x610) && (inCode <= 0x61a))
+      || ((inCode >= 0x64b) && (inCode <= 0x65f)) || (inCode == 0x670)
+      || ((inCode >= 0x6d6) && (inCode <= 0x6dc))
+      || ((inCode >= 0x6df) && (inCode <= 0x6e4))
+      || (inCode == 0x6e7) || (inCode == 0x6e8)
+      || ((inCode >= 0x6ea) && (inCode <= 0x6ed)))
+    return GLC_JOINING_TRANSPARENT;
+
+  /* TATWEEL and ZERO WIDTH JOINER join on both sides but have no forms */
+  if ((inCode == 0x640) || (inCode == 0x200d))
+    return GLC_JOINING_DUAL;
+
+  if ((inCode < __glcArabicForms[lower].code)
+      || (inCode > __glcArabicForms[upper].code))
+    return GLC_JOINING_NONE;
+
+  /* Binary search of the letter */
+  while (lower <= upper) {
+    GLint middle = (lower + upper) >> 1;
+
+    if (inCode < __glcArabicForms[middle].code)
+      upper = middle - 1;
+    else if (inCode > __glcArabicForms[middle].code)
+      lower = middle + 1;
+    else {
+      *outIndex = middle;
+      switch(__glcArabicForms[middle].count) {
+      case 4:
+	return GLC_JOINING_DUAL;
+      case 2:
+	return GLC_JOINING_RIGHT;
+      default:
+	return GLC_JOINING_NONE;
+      }
+    }
+  }
+
+  return GLC_JOINING_NONE;
+}
+
+
+
+/* Replace the letter at 'inIndex' in 'ioString' by its contextual form
+ * according to the letters it is joined to.
+ */
+static void __glcSetContextualForm(GLCchar32* ioString, const GLint inIndex,
+				   const GLint inFormIndex,
+				   const GLboolean inJoinsPrevious,
+				   const GLboolean inJoinsNext)
+{
+  GLint form = 0;
+
+  if (inFormIndex < 0)
+    return;
+
+  if (inJoinsPrevious)
+    form = inJoinsNext ? 3 : 1;		/* Medial or final form */
+  else if (inJoinsNext)
+    form = 2;				/* Initial form */
+
+  if (form < __glcArabicForms[inFormIndex].count)
+    ioString[inIndex] = __glcArabicForms[inFormIndex].form + form;
+}
+
+
+
+/* Shaping stage of the string conversion : the Arabic letters of 'ioString'
+ * (which is stored in logical order) are replaced by their contextual forms
+ * so that the render and measure commands use the glyphs of the joined
+ * letters. Each character is replaced by exactly one character so that the
+ * indices of the characters of the string are left unchanged.
+ */
+static void __glcShapeString(GLCchar32* ioString, const GLint inLength)
+{
+  GLint i = 0;
+  GLint previous = -1;		/* Index of the previous letter */
+  GLint previousType = GLC_JOINING_NONE;
+  GLint previousForm = -1;
+  GLboolean previousJoinsPrevious = GL_FALSE;
+
+  for (i = 0; i < inLength; i++) {
+    GLint formIndex = -1;
+    GLint type = __glcGetJoiningType(ioString[i], &formIndex);
+    GLboolean joins = GL_FALSE;
+
+    if (type == GLC_JOINING_TRANSPARENT)
+      continue;
+
+    /* The letter joins the previous one if the previous letter can be joined
+     * on its left side.
+     */
+    joins = (previousType == GLC_JOINING_DUAL)
+      && ((type == GLC_JOINING_DUAL) || (type == GLC_JOINING_RIGHT));
+
+    if (previous >= 0)
+      __glcSetContextualForm(ioString, previous, previousForm,
+			     previousJoinsPrevious, joins);
+
+    previous = i;
+    previousType = type;
+    previousForm = formIndex;
+    previousJoinsPrevious = joins;
+  }
+
+  if (previous >= 0)
+    __glcSetContextualForm(ioString, previous, previousForm,
+			   previousJoinsPrevious, GL_FALSE);
+}
+
+
+
+/* Return the nominal character of 'inCode' if it is one of the contextual
+ * forms that __glcShapeString() may have produced, and 0 otherwise.
+ */
+GLint __glcGetNominalCode(const GLint inCode)
+{
+  GLint i = 0;
+
+  if ((inCode < 0xfb50) || (inCode > 0xfefc))
+    return 0;
+
+  for (i = 0; i < (GLint)(sizeof(__glcArabicForms)
+			   / sizeof(__glcArabicForms[0])); i++) {
+    if ((inCode >= __glcArabicForms[i].form)
+	&& (inCode < __glcArabicForms[i].form + __glcArabicForms[i].count))
+      return __glcArabicForms[i].code;
+  }
+
+  return 0;
+}
+
+
+
+/* Return the size in bytes of 'inString' which is encoded in the format
+ * 'inStringType'. If 'inCount' is negative, the string is zero terminated,
+ * otherwise it is made of 'inCount' characters.
+ */
+static GLint __glcStringSize(const GLCchar* inString, const GLint inStringType,
+			     const GLint inCount)
+{
+  GLint count = 0;
+
+  switch(inStringType) {
+  case GLC_UCS1:
+    return (inCount < 0) ? (GLint)strlen((const char*)inString) : inCount;
+  case GLC_UCS2:
+    if (inCount < 0)
+      for (; ((const GLCchar16*)inString)[count]; count++);
+    else
+      count = inCount;
+    return count * sizeof(GLCchar16);
+  case GLC_UCS4:
+    if (inCount < 0)
+      for (; ((const GLCchar32*)inString)[count]; count++);
+    else
+      count = inCount;
+    return count * sizeof(GLCchar32);
+  case GLC_UTF8_QSO:
+    {
+      const GLCchar8* utf8 = (const GLCchar8*)inString;
+      GLint i = 0;
+
+      if (inCount < 0)
+	return strlen((const char*)utf8);
+
+      /* Skip the characters according to the length encoded in their leading
+       * byte.
+       */
+      for (i = 0; i < inCount; i++) {
+	GLCchar8 c = utf8[count];
+
+	if (c < 0xc0)
+	  count += 1;
+	else if (c < 0xe0)
+	  count += 2;
+	else if (c < 0xf0)
+	  count += 3;
+	else if (c < 0xf8)
+	  count += 4;
+	else if (c < 0xfc)
+	  count += 5;
+	else
+	  count += 6;
+      }
+      return count;
+    }
+  }
+
+  return 0;
+}
+
+
+
+/* Look for the string 'inString' of 'inSize' bytes in the string cache of the
+ * context. The function returns the entry of the string or NULL if it is not
+ * in the cache.
+ */
+static __GLCstringEntry* __glcLookupVisualString(__GLCcontext* inContext,
+						 const GLCchar* inString,
+						 const GLint inSize,
+						 GLboolean* outIsRTL,
+						 __GLCstringEntry** outEntry)
+{
+  __GLCstringEntry* entry =
+    __glcStringCacheLookup(inContext->stringCache, (const GLCchar8*)inString,
+			   inSize, inContext->stringState.stringType);
+
+  if (entry) {
+    *outIsRTL = entry->isRightToLeft;
+    if (outEntry)
+      *outEntry = entry;
+  }
+
+  return entry;
+}
+
+
+
+/* Store the conversion of 'inString' in the string cache of the context. The
+ * function returns the visual string to be used by the caller : the copy that
+ * is stored in the cache, or 'inVisualString' if the string could not be
+ * cached.
+ */
+static GLCchar32* __glcCacheVisualString(__GLCcontext* inContext,
+					 const GLCchar* inString,
+					 const GLint inSize,
+					 GLCchar32* inVisualString,
+					 const GLint inLength,
+					 const GLboolean inIsRTL,
+					 __GLCstringEntry** outEntry)
+{
+  __GLCstringEntry* entry =
+    __glcStringCacheInsert(inContext->stringCache, (const GLCchar8*)inString,
+			   inSize, inContext->stringState.stringType,
+			   inVisualString, inLength, inIsRTL);
+
+  if (!entry)
+    return inVisualString;
+
+  if (outEntry)
+    *outEntry = entry;
+
+  return entry->visualString;
+}
+
+
+
 /* Convert 'inString' (stored in logical order) to UCS4 format and return a
  * copy of the converted string in visual order.
  */
 GLCchar32* __glcConvertToVisualUcs4(__GLCcontext* inContext,
 				    GLboolean *outIsRTL, GLint *outLength,
-				    const GLCchar* inString)
+				    const GLCchar* inString,
+				    __GLCstringEntry** outEntry)
 {
   GLCchar32* string = NULL;
   int length = 0;
   FriBidiCharType base = FRIBIDI_TYPE_ON;
   GLCchar32* visualString = NULL;
+  GLint size = 0;
 
   assert(inString);
 
+  if (outEntry)
+    *outEntry = NULL;
+
+  /* Look for the string in the cache. The cache is not used by the commands
+   * issued from a callback function since they could destroy the entry that
+   * the calling command is using.
+   */
+  if (inContext->enableState.stringCache && !inContext->isInCallbackFunc) {
+    __GLCstringEntry* entry = NULL;
+
+    size = __glcStringSize(inString, inContext->stringState.stringType, -1);
+    entry = __glcLookupVisualString(inContext, inString, size, outIsRTL,
+				    outEntry);
+    if (entry) {
+      *outLength = entry->length;
+      return entry->visualString;
+    }
+  }
+
   switch(inContext->stringState.stringType) {
   case GLC_UCS1:
     {
@@ -622,41 +1041,35 @@ GLCchar32* __glcConvertToVisualUcs4(__GLCcontext* inContext,
     break;
   case GLC_UTF8_QSO:
     {
-      GLCchar32* ucs4 = NULL;
-      const GLCchar8* utf8 = NULL;
-      GLCchar32 buffer = 0;
-      int shift = 0;
+      const GLCchar8* utf8 = (const GLCchar8*)inString;
+      int bytes = strlen((const char*)utf8);
 
-      /* Determine the length of the final string */
-      utf8 = (const GLCchar8*)inString;
-      while(*utf8) {
-	shift = FcUtf8ToUcs4(utf8, &buffer, strlen((const char*)utf8));
-	if (shift < 0) {
-	  /* There is an ill-formed character in the UTF-8 string, abort */
-	  return NULL;
-	}
-	utf8 += shift;
-	length++;
-      }
-
-      /* Allocate the room to store the final string */
+      /* Allocate the room to store the final string : the number of
+       * characters can not exceed the number of bytes of the UTF-8 string.
+       */
       string = (GLCchar32*)__glcContextQueryBuffer(inContext,
-					      2*(length+1)*sizeof(GLCchar32));
+					      2*(bytes+1)*sizeof(GLCchar32));
       if (!string)
 	return NULL; /* GLC_RESOURCE_ERROR has been raised */
 
       /* Perform the conversion */
-      utf8 = (const GLCchar8*)inString;
-      ucs4 = (GLCchar32*)string;
-      while(*utf8)
-	utf8 += FcUtf8ToUcs4(utf8, ucs4++, strlen((const char*)utf8));
+      length = __glcUtf8ToUcs4String(utf8, bytes, string, bytes);
+      if (length < 0) {
+	/* There is an ill-formed character in the UTF-8 string, abort */
+	return NULL;
+      }
 
-      *ucs4 = 0; /* Add the '\0' termination of the string */
+      string[length] = 0; /* Add the '\0' termination of the string */
     }
     break;
   }
 
-  if (length) {
+  /* Left-to-right strings are already in visual order and have no letters to
+   * be shaped : the shaping stage and the bidirectional algorithm are skipped
+   * and the logical string is returned.
+   */
+  if (length && __glcStringNeedsBidi(string, length)) {
+    __glcShapeString(string, length);
     visualString = string + length + 1;
     if (!fribidi_log2vis(string, length, &base, visualString, NULL, NULL,
                          NULL)) {
@@ -666,11 +1079,17 @@ GLCchar32* __glcConvertToVisualUcs4(__GLCcontext* inContext,
 
     *outIsRTL = FRIBIDI_IS_RTL(base) ? GL_TRUE : GL_FALSE;
   }
-  else
+  else {
     visualString = string;
+    *outIsRTL = GL_FALSE;
+  }
 
   *outLength = length;
 
+  if (size)
+    return __glcCacheVisualString(inContext, inString, size, visualString,
+				  length, *outIsRTL, outEntry);
+
   return visualString;
 }
 
@@ -682,14 +1101,31 @@ GLCchar32* __glcConvertToVisualUcs4(__GLCcontext* inContext,
 GLCchar32* __glcConvertCountedStringToVisualUcs4(__GLCcontext* inContext,
 						GLboolean *outIsRTL,
 						const GLCchar* inString,
-						const GLint inCount)
+						const GLint inCount,
+						__GLCstringEntry** outEntry)
 {
   GLCchar32* string = NULL;
   FriBidiCharType base = FRIBIDI_TYPE_ON;
   GLCchar32* visualString = NULL;
+  GLint size = 0;
 
   assert(inString);
 
+  if (outEntry)
+    *outEntry = NULL;
+
+  /* Look for the string in the cache */
+  if (inContext->enableState.stringCache && !inContext->isInCallbackFunc) {
+    __GLCstringEntry* entry = NULL;
+
+    size = __glcStringSize(inString, inContext->stringState.stringType,
+			   inCount);
+    entry = __glcLookupVisualString(inContext, inString, size, outIsRTL,
+				    outEntry);
+    if (entry)
+      return entry->visualString;
+  }
+
   switch(inContext->stringState.stringType) {
   case GLC_UCS1:
     {
@@ -747,36 +1183,44 @@ GLCchar32* __glcConvertCountedStringToVisualUcs4(__GLCcontext* inContext,
     break;
   case GLC_UTF8_QSO:
     {
-      GLCchar32* ucs4 = NULL;
-      const GLCchar8* utf8 = NULL;
-      GLint i = 0;
-
       /* Allocate the room to store the final string */
       string = (GLCchar32*)__glcContextQueryBuffer(inContext,
 					      2*(inCount+1)*sizeof(GLCchar32));
       if (!string)
 	return NULL; /* GLC_RESOURCE_ERROR has been raised */
 
-      /* Perform the conversion */
-      utf8 = (const GLCchar8*)inString;
-      ucs4 = (GLCchar32*)string;
-
-      for (i = 0; i < inCount; i++)
-	utf8 += FcUtf8ToUcs4(utf8, ucs4++, strlen((const char*)utf8));
+      /* Perform the conversion. The length of the string in bytes is unknown
+       * but it is at least 'inCount' bytes long.
+       */
+      if (__glcUtf8ToUcs4String((const GLCchar8*)inString, INT_MAX, string,
+				inCount) < inCount)
+	return NULL;
 
-      *ucs4 = 0; /* Add the '\0' termination of the string */
+      string[inCount] = 0; /* Add the '\0' termination of the string */
     }
     break;
   }
 
-  visualString = string + inCount;
-  if (!fribidi_log2vis(string, inCount, &base, visualString, NULL, NULL,
-		       NULL)) {
-    __glcRaiseError(GLC_RESOURCE_ERROR);
-    return NULL;
+  /* Left-to-right strings are already in visual order and are not shaped */
+  if (__glcStringNeedsBidi(string, inCount)) {
+    __glcShapeString(string, inCount);
+    visualString = string + inCount;
+    if (!fribidi_log2vis(string, inCount, &base, visualString, NULL, NULL,
+			 NULL)) {
+      __glcRaiseError(GLC_RESOURCE_ERROR);
+      return NULL;
+    }
+
+    *outIsRTL = FRIBIDI_IS_RTL(base) ? GL_TRUE : GL_FALSE;
+  }
+  else {
+    visualString = string;
+    *outIsRTL = GL_FALSE;
   }
 
-  *outIsRTL = FRIBIDI_IS_RTL(base) ? GL_TRUE : GL_FALSE;
+  if (size)
+    return __glcCacheVisualString(inContext, inString, size, visualString,
+				  inCount, *outIsRTL, outEntry);
 
   return visualString;
 }
@@ -32,6 +32,7 @@
 #define BUFSIZE MAX_PATH
 
 #include "texture.h"
+#include <GL/glu.h>
 #include FT_MODULE_H
 
 __GLCcommonArea __glcCommonArea;
@@ -106,8 +107,10 @@ __GLCcontext* __glcContextCreate(GLint inContext)
   This->currentFontList.tail = NULL;
   This->fontList.head = NULL;
   This->fontList.tail = NULL;
+  This->textList.head = NULL;
+  This->textList.tail = NULL;
 
-  This->isCurrent = GL_FALSE;
+  This->state = GLC_CONTEXT_RELEASED;
   This->isInGlobalCommand = GL_FALSE;
   This->id = inContext;
   This->pendingDelete = GL_FALSE;
@@ -121,6 +124,7 @@ __GLCcontext* __glcContextCreate(GLint inContext)
   This->enableState.hinting = GL_FALSE;
   This->enableState.extrude = GL_FALSE;
   This->enableState.kerning = GL_FALSE;
+  This->enableState.stringCache = GL_FALSE;
   This->renderState.resolution = 0.;
   This->renderState.renderStyle = GLC_BITMAP;
   This->bitmapMatrixStackDepth = 1;
@@ -159,8 +163,8 @@ __GLCcontext* __glcContextCreate(GLint inContext)
     __glcFree(This);
     return NULL;
   }
-  This->controlPoints = __glcArrayCreate(5 * sizeof(GLfloat));
-  if (!This->controlPoints) {
+  This->endContour = __glcArrayCreate(sizeof(int));
+  if (!This->endContour) {
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
@@ -173,12 +177,13 @@ __GLCcontext* __glcContextCreate(GLint inContext)
     __glcFree(This);
     return NULL;
   }
-  This->endContour = __glcArrayCreate(sizeof(int));
-  if (!This->endContour) {
-    __glcArrayDestroy(This->controlPoints);
+
+  This->vertexIndices = __glcArrayCreate(sizeof(GLuint));
+  if (!This->vertexIndices) {
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
+    __glcArrayDestroy(This->endContour);
     __glcArrayDestroy(This->catalogList);
     __glcRaiseError(GLC_RESOURCE_ERROR);
 #ifdef FT_CACHE_H
@@ -189,13 +194,13 @@ __GLCcontext* __glcContextCreate(GLint inContext)
     return NULL;
   }
 
-  This->vertexIndices = __glcArrayCreate(sizeof(GLuint));
-  if (!This->vertexIndices) {
-    __glcArrayDestroy(This->controlPoints);
+  This->geomBatches = __glcArrayCreate(sizeof(__GLCgeomBatch));
+  if (!This->geomBatches) {
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
     __glcArrayDestroy(This->endContour);
+    __glcArrayDestroy(This->vertexIndices);
     __glcArrayDestroy(This->catalogList);
     __glcRaiseError(GLC_RESOURCE_ERROR);
 #ifdef FT_CACHE_H
@@ -206,9 +211,79 @@ __GLCcontext* __glcContextCreate(GLint inContext)
     return NULL;
   }
 
-  This->geomBatches = __glcArrayCreate(sizeof(__GLCgeomBatch));
-  if (!This->geomBatches) {
-    __glcArrayDestroy(This->controlPoints);
+  This->tesselator = __glcTesselatorCreate();
+  if (!This->tesselator) {
+    __glcArrayDestroy(This->geomBatches);
+    __glcArrayDestroy(This->vertexArray);
+    __glcArrayDestroy(This->measurementBuffer);
+    __glcArrayDestroy(This->masterHashTable);
+    __glcArrayDestroy(This->endContour);
+    __glcArrayDestroy(This->vertexIndices);
+    __glcArrayDestroy(This->catalogList);
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+#ifdef FT_CACHE_H
+    FTC_Manager_Done(This->cache);
+#endif
+    FT_Done_Library(This->library);
+    __glcFree(This);
+    return NULL;
+  }
+
+  This->arena = __glcArenaCreate();
+  if (!This->arena) {
+    gluDeleteTess(This->tesselator);
+    __glcArrayDestroy(This->geomBatches);
+    __glcArrayDestroy(This->vertexArray);
+    __glcArrayDestroy(This->measurementBuffer);
+    __glcArrayDestroy(This->masterHashTable);
+    __glcArrayDestroy(This->endContour);
+    __glcArrayDestroy(This->vertexIndices);
+    __glcArrayDestroy(This->catalogList);
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+#ifdef FT_CACHE_H
+    FTC_Manager_Done(This->cache);
+#endif
+    FT_Done_Library(This->library);
+    __glcFree(This);
+    return NULL;
+  }
+
+  This->glyphPool = __glcPoolCreate(sizeof(__GLCglyph));
+  This->atlasPool = __glcPoolCreate(sizeof(__GLCatlasElement));
+  This->nodePool = __glcPoolCreate(sizeof(FT_ListNodeRec));
+  if (!This->glyphPool || !This->atlasPool || !This->nodePool) {
+    if (This->nodePool)
+      __glcPoolDestroy(This->nodePool);
+    if (This->atlasPool)
+      __glcPoolDestroy(This->atlasPool);
+    if (This->glyphPool)
+      __glcPoolDestroy(This->glyphPool);
+    __glcArenaDestroy(This->arena);
+    gluDeleteTess(This->tesselator);
+    __glcArrayDestroy(This->geomBatches);
+    __glcArrayDestroy(This->vertexArray);
+    __glcArrayDestroy(This->measurementBuffer);
+    __glcArrayDestroy(This->masterHashTable);
+    __glcArrayDestroy(This->endContour);
+    __glcArrayDestroy(This->vertexIndices);
+    __glcArrayDestroy(This->catalogList);
+    __glcRaiseError(GLC_RESOURCE_ERROR);
+#ifdef FT_CACHE_H
+    FTC_Manager_Done(This->cache);
+#endif
+    FT_Done_Library(This->library);
+    __glcFree(This);
+    return NULL;
+  }
+
+  This->stringCache = __glcStringCacheCreate();
+  if (!This->stringCache) {
+    __glcPoolDestroy(This->nodePool);
+    __glcPoolDestroy(This->atlasPool);
+    __glcPoolDestroy(This->glyphPool);
+    __glcArenaDestroy(This->arena);
+    gluDeleteTess(This->tesselator);
+    __glcArrayDestroy(This->geomBatches);
     __glcArrayDestroy(This->vertexArray);
     __glcArrayDestroy(This->measurementBuffer);
     __glcArrayDestroy(This->masterHashTable);
@@ -343,6 +418,7 @@ static void __glcFontDestructor(FT_Memory GLC_UNUSED_ARG(inMemory),
 void __glcContextDestroy(__GLCcontext *This)
 {
   int i = 0;
+  FT_ListNode node = NULL;
 
   assert(This);
 
@@ -357,30 +433,39 @@ void __glcContextDestroy(__GLCcontext *This)
 
   /* Destroy GLC_CURRENT_FONT_LIST */
   FT_List_Finalize(&This->currentFontList, NULL,
-		   &__glcCommonArea.memoryManager, NULL);
+		   &This->nodePool->memory, NULL);
 
   /* Destroy GLC_FONT_LIST */
   FT_List_Finalize(&This->fontList, __glcFontDestructor,
-                   &__glcCommonArea.memoryManager, This);
+                   &This->nodePool->memory, This);
+
+  /* Destroy the text objects generated by glcGenTextQSO() */
+  node = This->textList.head;
+  while (node) {
+    FT_ListNode next = node->next;
+
+    __glcTextDestroy((__GLCtext*)node, This);
+    node = next;
+  }
 
   if (This->masterHashTable)
     __glcArrayDestroy(This->masterHashTable);
 
-  FT_List_Finalize(&This->atlasList, NULL,
-		   &__glcCommonArea.memoryManager, NULL);
-
   if (This->bufferSize)
     __glcFree(This->buffer);
 
   if (This->measurementBuffer)
     __glcArrayDestroy(This->measurementBuffer);
 
+  if (This->paragraphString)
+    __glcArrayDestroy(This->paragraphString);
+
+  if (This->paragraphLines)
+    __glcArrayDestroy(This->paragraphLines);
+
   if (This->vertexArray)
     __glcArrayDestroy(This->vertexArray);
 
-  if (This->controlPoints)
-    __glcArrayDestroy(This->controlPoints);
-
   if (This->endContour)
     __glcArrayDestroy(This->endContour);
 
@@ -390,6 +475,27 @@ void __glcContextDestroy(__GLCcontext *This)
   if (This->geomBatches)
     __glcArrayDestroy(This->geomBatches);
 
+  if (This->tesselator)
+    gluDeleteTess(This->tesselator);
+
+  if (This->arena)
+    __glcArenaDestroy(This->arena);
+
+  if (This->stringCache)
+    __glcStringCacheDestroy(This->stringCache);
+
+  /* The nodes of the lists and the glyphs have already been released but the
+   * elements of the texture atlas are released at once with their pool.
+   */
+  if (This->nodePool)
+    __glcPoolDestroy(This->nodePool);
+
+  if (This->atlasPool)
+    __glcPoolDestroy(This->atlasPool);
+
+  if (This->glyphPool)
+    __glcPoolDestroy(This->glyphPool);
+
 #ifdef FT_CACHE_H
   FTC_Manager_Done(This->cache);
 #endif
@@ -0,0 +1,205 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * The purpose of this test is to check that contexts can be made current,
+ * released and deleted concurrently by several threads. The worker threads
+ * keep on making contexts current and releasing them while the main thread
+ * deletes them and generates new ones. Each pending deletion must be executed
+ * exactly once by the thread which releases the context, and no context must
+ * be destroyed while another thread is still using it. The main thread also
+ * generates enough extra contexts for the context table to grow several times
+ * while the other threads are reading it.
+ */
+
+#include "GL/glc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#if defined __APPLE__ && defined __MACH__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+#define NUM_THREADS 4
+#define NUM_CONTEXTS 8
+#define NUM_LOOPS 500
+#define NUM_EXTRA_CONTEXTS 3
+
+volatile GLint ctx[NUM_CONTEXTS];
+GLint extra[NUM_LOOPS * NUM_EXTRA_CONTEXTS];
+volatile int stop = 0;
+int magic = 0xdeadbeef;
+
+void* da_thread(void *arg)
+{
+  int i = 0;
+  unsigned int seed = (unsigned int)(size_t)arg;
+
+  while (!stop) {
+    GLint id = ctx[(seed >> 8) % NUM_CONTEXTS];
+    GLCenum err;
+
+    seed = seed * 1103515245 + 12345;
+
+    glcContext(id);
+    err = glcGetError();
+
+    /* glcContext() may raise GLC_RESOURCE_ERROR since no GL context is current
+     * to this thread, but the GLC context must nonetheless have been made
+     * current. Otherwise the context must have been current to another thread
+     * or deleted in the meantime.
+     */
+    if (glcGetCurrentContext() != id) {
+      if ((err != GLC_STATE_ERROR) && (err != GLC_PARAMETER_ERROR)) {
+	printf("Thread %d : Unexpected error : 0x%X\n", (int)(size_t)arg,
+	       (int)err);
+	return &magic;
+      }
+      continue;
+    }
+
+    /* The context is current to this thread so it must not be deleted even
+     * though the main thread may have requested its deletion.
+     */
+    if (!glcIsContext(id)) {
+      printf("Thread %d : Unexpected deletion of context %d\n",
+	     (int)(size_t)arg, (int)id);
+      return &magic;
+    }
+
+    /* Release the context and execute its pending deletion if any */
+    if (i++ & 1)
+      glcContext(0);
+  }
+
+  glcContext(0);
+  return NULL;
+}
+
+int main(int argc, char **argv)
+{
+  pthread_t thread[NUM_THREADS];
+  GLCenum err;
+  void *return_value = NULL;
+  GLint *list = NULL;
+  int i = 0;
+
+  /* Needed to initialize an OpenGL context */
+  glutInit(&argc, argv);
+  glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
+  glutCreateWindow("test19");
+
+  for (i = 0; i < NUM_CONTEXTS; i++)
+    ctx[i] = glcGenContext();
+
+  for (i = 0; i < NUM_THREADS; i++) {
+    if (pthread_create(&thread[i], NULL, da_thread, (void*)(size_t)(i + 1))) {
+      printf("Main Thread : Failed to create pthread\n");
+      return -1;
+    }
+  }
+
+  /* Delete the contexts while the other threads are using them and replace
+   * them by new ones.
+   */
+  for (i = 0; i < NUM_LOOPS; i++) {
+    int j = i % NUM_CONTEXTS;
+    int k = 0;
+
+    glcDeleteContext(ctx[j]);
+    err = glcGetError();
+    if (err) {
+      printf("Main Thread : Unexpected error : 0x%X\n", (int)err);
+      stop = 1;
+      return -1;
+    }
+
+    ctx[j] = glcGenContext();
+    if (!ctx[j]) {
+      printf("Main Thread : Failed to generate a context (error 0x%X)\n",
+	     (int)glcGetError());
+      stop = 1;
+      return -1;
+    }
+
+    for (k = 0; k < NUM_EXTRA_CONTEXTS; k++) {
+      extra[i * NUM_EXTRA_CONTEXTS + k] = glcGenContext();
+      if (!extra[i * NUM_EXTRA_CONTEXTS + k]) {
+	printf("Main Thread : Failed to generate context #%d (error 0x%X)\n",
+	       i * NUM_EXTRA_CONTEXTS + k + 1, (int)glcGetError());
+	stop = 1;
+	return -1;
+      }
+    }
+  }
+
+  stop = 1;
+
+  for (i = 0; i < NUM_THREADS; i++) {
+    if (pthread_join(thread[i], &return_value)) {
+      printf("Main Thread : Failed to join Thread %d\n", i + 1);
+      return -1;
+    }
+
+    if (return_value) {
+      printf("Main Thread : An error occured in Thread %d\n", i + 1);
+      return -1;
+    }
+  }
+
+  /* All the threads have released their context so only the contexts that
+   * have not been deleted must remain.
+   */
+  list = glcGetAllContexts();
+  for (i = 0; list[i]; i++);
+  free(list);
+  if (i != NUM_CONTEXTS + NUM_LOOPS * NUM_EXTRA_CONTEXTS) {
+    printf("Main Thread : %d contexts found, %d expected\n", i,
+	   NUM_CONTEXTS + NUM_LOOPS * NUM_EXTRA_CONTEXTS);
+    return -1;
+  }
+
+  for (i = 0; i < NUM_LOOPS * NUM_EXTRA_CONTEXTS; i++) {
+    if (!glcIsContext(extra[i])) {
+      printf("Main Thread : Context %d has been lost\n", (int)extra[i]);
+      return -1;
+    }
+    glcDeleteContext(extra[i]);
+  }
+
+  for (i = 0; i < NUM_CONTEXTS; i++) {
+    if (!glcIsContext(ctx[i])) {
+      printf("Main Thread : Unexpected deletion of context %d\n",
+	     (int)ctx[i]);
+      return -1;
+    }
+    glcDeleteContext(ctx[i]);
+    if (glcIsContext(ctx[i])) {
+      printf("Main Thread : Deletion of context %d has not been executed\n",
+	     (int)ctx[i]);
+      return -1;
+    }
+  }
+
+  printf("Test successful!\n");
+  return 0;
+}
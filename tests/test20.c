@@ -0,0 +1,294 @@
+/* QuesoGLC
+ * A free implementation of the OpenGL Character Renderer (GLC)
+ * Copyright (c) 2002, 2004-2009, Bertrand Coconnier
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+/* $Id$ */
+
+/** \file
+ * The purpose of this test is to measure the contention between the threads
+ * that switch their contexts and the threads that create contexts and edit
+ * their catalogs. NUM_THREADS threads keep on making their NUM_CONTEXTS
+ * contexts current in turn, first alone then while NUM_CATALOG_THREADS other
+ * threads generate contexts, append and remove a catalog and delete the
+ * contexts. The latencies of glcContext() and of glcGetAllContexts(), which
+ * locks the context table, are reported for both phases : they must not wait
+ * for the Fontconfig calls of the other threads.
+ */
+
+#include "GL/glc.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+#if defined __APPLE__ && defined __MACH__
+#include <GLUT/glut.h>
+#else
+#include <GL/glut.h>
+#endif
+
+#define NUM_THREADS 4
+#define NUM_CONTEXTS 4
+#define NUM_CATALOG_THREADS 2
+#define NUM_LOOPS 50
+#define REFERENCE_DURATION 0.5
+#define SLOW_CALL 1e-3
+
+typedef struct {
+  int count;
+  int slow;			/* Calls that took more than SLOW_CALL */
+  double total;
+  double max;
+} latency;
+
+typedef struct {
+  GLint ctx[NUM_CONTEXTS];
+  latency switches;
+  latency lists;
+} threadStats;
+
+threadStats stats[NUM_THREADS];
+volatile int stop = 0;
+int magic = 0xdeadbeef;
+const char* catalogs[] = {"/usr/share/fonts", "/usr/X11R6/lib/X11/fonts",
+			  "/usr/lib/X11/fonts", NULL};
+
+static double now(void)
+{
+  struct timeval tv;
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static void addLatency(latency* l, double elapsed)
+{
+  l->count++;
+  if (elapsed > SLOW_CALL)
+    l->slow++;
+  l->total += elapsed;
+  if (elapsed > l->max)
+    l->max = elapsed;
+}
+
+static void mergeLatency(latency* l, const latency* other)
+{
+  l->count += other->count;
+  l->slow += other->slow;
+  l->total += other->total;
+  if (other->max > l->max)
+    l->max = other->max;
+}
+
+static void printLatency(const char* name, const latency* l)
+{
+  printf("  %s : %d calls, mean %.2f us, max %.3f ms, %d above %g ms\n",
+	 name, l->count, l->count ? l->total * 1e6 / l->count : 0.,
+	 l->max * 1e3, l->slow, SLOW_CALL * 1e3);
+}
+
+void* switch_thread(void *arg)
+{
+  threadStats *s = (threadStats*)arg;
+  int i = 0;
+
+  while (!stop) {
+    GLint id = s->ctx[i++ % NUM_CONTEXTS];
+    double start = now();
+    double elapsed = 0.;
+    GLint *list = NULL;
+
+    glcContext(id);
+    elapsed = now() - start;
+    /* glcContext() may raise GLC_RESOURCE_ERROR since no GL context is current
+     * to this thread.
+     */
+    glcGetError();
+
+    if (glcGetCurrentContext() != id) {
+      printf("Thread %d : Context %d has not been made current\n",
+	     (int)(s - stats) + 1, (int)id);
+      return &magic;
+    }
+
+    addLatency(&s->switches, elapsed);
+
+    start = now();
+    list = glcGetAllContexts();
+    addLatency(&s->lists, now() - start);
+    if (!list) {
+      printf("Thread %d : Failed to get the list of contexts\n",
+	     (int)(s - stats) + 1);
+      return &magic;
+    }
+    free(list);
+  }
+
+  glcContext(0);
+  return NULL;
+}
+
+void* catalog_thread(void *arg)
+{
+  int i = 0;
+
+  for (i = 0; i < NUM_LOOPS; i++) {
+    GLint id = glcGenContext();
+    int j = 0;
+
+    if (!id) {
+      printf("Catalog Thread %d : Failed to generate a context\n",
+	     (int)(size_t)arg);
+      return &magic;
+    }
+
+    glcContext(id);
+    glcGetError();
+
+    /* Append the first catalog that exists then remove it */
+    for (j = 0; catalogs[j]; j++) {
+      glcAppendCatalog(catalogs[j]);
+      if (!glcGetError())
+	break;
+    }
+
+    if (catalogs[j]) {
+      glcRemoveCatalog(glcGeti(GLC_CATALOG_COUNT) - 1);
+      if (glcGetError()) {
+	printf("Catalog Thread %d : Failed to remove catalog %s\n",
+	       (int)(size_t)arg, catalogs[j]);
+	return &magic;
+      }
+    }
+
+    glcContext(0);
+    glcDeleteContext(id);
+  }
+
+  return NULL;
+}
+
+/* Run the threads that switch contexts, and the catalog threads if
+ * 'withCatalogs' is nonzero, then print the latencies of glcContext().
+ */
+static int run(int withCatalogs)
+{
+  pthread_t thread[NUM_THREADS];
+  pthread_t catalogThread[NUM_CATALOG_THREADS];
+  void *return_value = NULL;
+  double start = now();
+  latency switches = {0, 0, 0., 0.};
+  latency lists = {0, 0, 0., 0.};
+  int error = 0;
+  int i = 0;
+
+  for (i = 0; i < NUM_THREADS; i++) {
+    memset(&stats[i].switches, 0, sizeof(latency));
+    memset(&stats[i].lists, 0, sizeof(latency));
+    if (pthread_create(&thread[i], NULL, switch_thread, &stats[i])) {
+      printf("Main Thread : Failed to create pthread\n");
+      return -1;
+    }
+  }
+
+  if (withCatalogs) {
+    for (i = 0; i < NUM_CATALOG_THREADS; i++) {
+      if (pthread_create(&catalogThread[i], NULL, catalog_thread,
+			 (void*)(size_t)(i + 1))) {
+	printf("Main Thread : Failed to create pthread\n");
+	stop = 1;
+	return -1;
+      }
+    }
+
+    for (i = 0; i < NUM_CATALOG_THREADS; i++) {
+      if (pthread_join(catalogThread[i], &return_value)) {
+	printf("Main Thread : Failed to join Catalog Thread %d\n", i + 1);
+	stop = 1;
+	return -1;
+      }
+      if (return_value)
+	error = 1;
+    }
+  }
+  else
+    usleep((useconds_t)(REFERENCE_DURATION * 1e6));
+
+  stop = 1;
+
+  for (i = 0; i < NUM_THREADS; i++) {
+    if (pthread_join(thread[i], &return_value)) {
+      printf("Main Thread : Failed to join Thread %d\n", i + 1);
+      return -1;
+    }
+    if (return_value)
+      error = 1;
+
+    mergeLatency(&switches, &stats[i].switches);
+    mergeLatency(&lists, &stats[i].lists);
+  }
+
+  stop = 0;
+
+  if (error) {
+    printf("Main Thread : An error occured in a thread\n");
+    return -1;
+  }
+
+  printf("%s : %d threads x %d contexts during %.3f s\n",
+	 withCatalogs ? "With catalog edits" : "Reference", NUM_THREADS,
+	 NUM_CONTEXTS, now() - start);
+  printLatency("glcContext()", &switches);
+  printLatency("glcGetAllContexts()", &lists);
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  int i = 0;
+  int j = 0;
+
+  /* Needed to initialize an OpenGL context */
+  glutInit(&argc, argv);
+  glutInitDisplayMode(GLUT_SINGLE | GLUT_RGB);
+  glutCreateWindow("test20");
+
+  for (i = 0; i < NUM_THREADS; i++) {
+    for (j = 0; j < NUM_CONTEXTS; j++) {
+      stats[i].ctx[j] = glcGenContext();
+      if (!stats[i].ctx[j]) {
+	printf("Main Thread : Failed to generate a context\n");
+	return -1;
+      }
+    }
+  }
+
+  if (run(0))
+    return -1;
+
+  if (run(1))
+    return -1;
+
+  for (i = 0; i < NUM_THREADS; i++) {
+    for (j = 0; j < NUM_CONTEXTS; j++)
+      glcDeleteContext(stats[i].ctx[j]);
+  }
+
+  printf("Test successful!\n");
+  return 0;
+}